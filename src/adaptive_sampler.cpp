@@ -0,0 +1,78 @@
+#include "adaptive_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr int kMaxDepth = 18;
+
+struct CurveSample {
+    double t, x, y;
+};
+
+// Distance from p to segment ab.
+static double seg_dist(const CurveSample& p,
+                       const CurveSample& a, const CurveSample& b) {
+    double dx = b.x - a.x, dy = b.y - a.y;
+    double len2 = dx * dx + dy * dy;
+    double u = len2 > 0.0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2 : 0.0;
+    u = std::clamp(u, 0.0, 1.0);
+    double ex = a.x + u * dx - p.x, ey = a.y + u * dy - p.y;
+    return std::sqrt(ex * ex + ey * ey);
+}
+
+void sample_adaptive(const GraphParams& p, const SamplePlan& plan,
+                     double px_per_unit, double tol_px,
+                     std::vector<double>& xs, std::vector<double>& ys,
+                     std::vector<double>* ts)
+{
+    xs.clear();
+    ys.clear();
+    if (ts) ts->clear();
+
+    auto at = [&p](double t) {
+        auto [x, y] = p.eval(t);
+        return CurveSample{t, x, y};
+    };
+    auto emit = [&](const CurveSample& s) {
+        xs.push_back(s.x);
+        ys.push_back(s.y);
+        if (ts) ts->push_back(s.t);
+    };
+
+    // The coarse grid is worked out in double and clamped before the int
+    // conversion: huge or infinite a/b would overflow it.  Splits come out
+    // of a budget, so at most kAdaptiveMaxVertices vertices come out.
+    const double max_coarse = kAdaptiveMaxVertices - 1;
+    double span   = plan.t1 - plan.t0;
+    double cycles = std::max(std::fabs(p.a), std::fabs(p.b)) * span / (2.0 * M_PI);
+    double want   = std::ceil(cycles) * 8.0;
+    int    coarse = static_cast<int>(std::isfinite(want)
+                                     ? std::clamp(want, 16.0, max_coarse) : max_coarse);
+    long   splits = kAdaptiveMaxVertices - 1 - coarse;
+    double tol    = tol_px / std::max(px_per_unit, 1e-12);   // model units
+
+    // Depth-first bisection with an explicit stack; right halves are pushed
+    // first so vertices come out in increasing t.
+    struct Span { CurveSample a, b; int depth; };
+    std::vector<Span> stack;
+
+    CurveSample prev = at(plan.t0);
+    emit(prev);
+    for (int i = 1; i <= coarse; ++i) {
+        CurveSample next = at(plan.t0 + span * i / coarse);
+        stack.push_back({prev, next, 0});
+        while (!stack.empty()) {
+            Span s = stack.back();
+            stack.pop_back();
+            CurveSample m = at(0.5 * (s.a.t + s.b.t));
+            if (splits > 0 && s.depth < kMaxDepth && seg_dist(m, s.a, s.b) > tol) {
+                --splits;
+                stack.push_back({m, s.b, s.depth + 1});
+                stack.push_back({s.a, m, s.depth + 1});
+            } else {
+                emit(s.b);
+            }
+        }
+        prev = next;
+    }
+}
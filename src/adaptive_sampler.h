@@ -0,0 +1,25 @@
+#pragma once
+
+#include "graph_params.h"
+
+#include <vector>
+
+// Screen-space adaptive sampling of the curve over plan.t0..plan.t1.
+//
+// Starts from a coarse grid (8 segments per oscillation of the faster
+// component) and bisects any interval whose midpoint lies more than tol_px
+// pixels from its chord.  That deviation grows with local curvature, so
+// tight turns get refined while near-straight stretches keep few vertices.
+// px_per_unit converts model units to pixels.  If ts is given it receives
+// the parameter value of every emitted vertex.
+//
+// At most kAdaptiveMaxVertices vertices are emitted; past that budget
+// (only reached for extreme a/b) intervals are no longer split.  It is
+// well below GraphParams::kMaxPoints because adaptive curves are built
+// synchronously on the UI thread.
+static constexpr int kAdaptiveMaxVertices = 1 << 20;
+
+void sample_adaptive(const GraphParams& p, const SamplePlan& plan,
+                     double px_per_unit, double tol_px,
+                     std::vector<double>& xs, std::vector<double>& ys,
+                     std::vector<double>* ts = nullptr);
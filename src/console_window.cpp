@@ -32,18 +32,46 @@ ConsoleWindow::ConsoleWindow(int w, int h, const char* title)
 }
 
 ConsoleWindow::~ConsoleWindow() {
+    Fl::remove_timeout(commit_cb, this);
     // Fl_Text_Display does not own the buffer.
     delete buffer_;
 }
 
+// Staged text reaches the buffer in one append per frame, so a burst of
+// output costs one gap move, one line-start update and one scroll.
 void ConsoleWindow::append_output(const char* text) {
-    buffer_->append(text);
-    // Scroll to end.
-    int total = buffer_->length();
-    display_->insert_position(total);
+    if (!output_.stage(text, std::strlen(text))) return;
+    double delay = frames_.request(frame_clock_now());
+    if (delay >= 0.0) Fl::add_timeout(delay, commit_cb, this);
+}
+
+void ConsoleWindow::flush() {
+    if (!frames_.pending()) return;
+    Fl::remove_timeout(commit_cb, this);
+    commit();
+}
+
+void ConsoleWindow::commit_cb(void* data) {
+    static_cast<ConsoleWindow*>(data)->commit();
+}
+
+void ConsoleWindow::commit() {
+    frames_.flush(frame_clock_now());
+    output_.commit(static_cast<std::size_t>(buffer_->length()),
+                   [this](std::size_t remove, const char* text) {
+                       if (remove) buffer_->remove(0, static_cast<int>(remove));
+                       buffer_->append(text);
+                   });
+    display_->insert_position(buffer_->length());
     display_->show_insert_position();
 }
 
+void ConsoleWindow::set_scrollback_limit(std::size_t lines) {
+    flush();
+    if (std::size_t drop = output_.set_limit(lines))
+        buffer_->remove(0, static_cast<int>(drop));
+}
+
 void ConsoleWindow::set_prompt(const char* prompt) {
     input_->label(prompt);
     // Adjust input x to accommodate label width.
@@ -61,6 +89,8 @@ int ConsoleWindow::handle(int event) {
         if (Fl::focus() == input_) {
             if (key == FL_Up)   { history_up();   return 1; }
             if (key == FL_Down) { history_down(); return 1; }
+            // Fl_Input consumes Ctrl+C only when it has a selection to copy.
+            if (key == 'c' && Fl::event_ctrl() && int_cb_) { int_cb_(); return 1; }
         }
     }
     return Fl_Double_Window::handle(event);
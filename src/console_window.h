@@ -1,10 +1,14 @@
 #pragma once
 
+#include "frame_scheduler.h"
+#include "output_stage.h"
+
 #include <FL/Fl_Double_Window.H>
 #include <FL/Fl_Text_Display.H>
 #include <FL/Fl_Text_Buffer.H>
 #include <FL/Fl_Input.H>
 
+#include <cstddef>
 #include <functional>
 #include <string>
 #include <vector>
@@ -20,9 +24,21 @@ public:
 
     void set_command_callback(CommandCallback cb) { cmd_cb_ = std::move(cb); }
 
-    // Append text to the output area and scroll to bottom.
+    // Called for Ctrl+C in the input field when no text is selected.
+    void set_interrupt_callback(std::function<void()> cb) { int_cb_ = std::move(cb); }
+
+    // Queue text for the output area.  Queued text is committed, and the
+    // view scrolled to the bottom, once per frame; once the scrollback
+    // limit is exceeded the oldest lines are dropped in chunks.
     void append_output(const char* text);
 
+    // Commit queued output now, e.g. to echo a command before it runs.
+    void flush();
+
+    // Lines of output kept (0 = unlimited; default Scrollback::kDefaultLimit).
+    void set_scrollback_limit(std::size_t lines);
+    ScrollbackStats scrollback_stats() const { return output_.stats(); }
+
     // Set the prompt prefix shown in the input field label.
     void set_prompt(const char* prompt);
 
@@ -30,14 +46,19 @@ public:
 
 private:
     static void on_input_enter(Fl_Widget* w, void* data);
+    static void commit_cb(void* data);
+    void commit();
     void history_up();
     void history_down();
 
     Fl_Text_Display* display_;
     Fl_Text_Buffer*  buffer_;
     Fl_Input*        input_;
+    OutputStage      output_;           // appended text not yet in buffer_
+    FrameScheduler   frames_;
 
     CommandCallback             cmd_cb_;
+    std::function<void()>       int_cb_;
     std::vector<std::string>    history_;
     int                         hist_pos_ = -1;
 };
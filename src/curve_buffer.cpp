@@ -0,0 +1,48 @@
+#include "curve_buffer.h"
+#include "adaptive_sampler.h"
+
+#include <algorithm>
+#include <cstring>
+
+static bool is_adaptive(const GraphParams& p, double px_per_unit) {
+    return p.sampling == Sampling::adaptive && px_per_unit > 0.0;
+}
+
+std::uint64_t CurveBuffer::key_for(const GraphParams& p, double px_per_unit) {
+    std::uint64_t k = p.fingerprint();
+    if (is_adaptive(p, px_per_unit)) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &px_per_unit, sizeof(bits));
+        k ^= bits * 0x9e3779b97f4a7c15ull;
+    }
+    return k;
+}
+
+bool CurveBuffer::update(const GraphParams& p, double px_per_unit) {
+    if (valid && key == key_for(p, px_per_unit)) return false;
+    rebuild(p, px_per_unit);
+    return true;
+}
+
+void CurveBuffer::rebuild(const GraphParams& p, double px_per_unit) {
+    valid = false;
+    SamplePlan plan = p.sample_plan();
+
+    if (is_adaptive(p, px_per_unit)) {
+        sample_adaptive(p, plan, px_per_unit, kAdaptiveTolPx, xs, ys);
+    } else {
+        xs.resize(plan.count);
+        ys.resize(plan.count);
+        double dt = plan.count > 1
+                  ? (plan.t1 - plan.t0) / static_cast<double>(plan.count - 1) : 0.0;
+        for (std::size_t start = 0; start < plan.count; start += kChunk) {
+            std::size_t len = std::min(kChunk, plan.count - start);
+            double t0 = plan.t0 + dt * static_cast<double>(start);
+            double t1 = plan.t0 + dt * static_cast<double>(start + len - 1);
+            p.eval_range(t0, t1, len, xs.data() + start, ys.data() + start);
+        }
+    }
+
+    key   = key_for(p, px_per_unit);
+    valid = true;
+}
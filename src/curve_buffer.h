@@ -0,0 +1,38 @@
+#pragma once
+
+#include "curve_stream.h"
+#include "graph_params.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Model-space samples of the curve, cached between repaints.
+// The buffer is keyed on GraphParams::fingerprint() and is only re-evaluated
+// when a parameter actually changes; exposes and resizes just re-project it.
+struct CurveBuffer {
+    // Screen-space error bound for adaptive sampling, in pixels.
+    static constexpr double kAdaptiveTolPx = 0.25;
+
+    // Uniform sampling is evaluated in the same chunks as stream_curve(),
+    // so the recurrence engine restarts at the same samples in both.
+    static constexpr std::size_t kChunk = kStreamChunk;
+
+    std::vector<double> xs, ys;
+    std::uint64_t key   = 0;
+    bool          valid = false;
+
+    // Cache key for `p` drawn at px_per_unit.  The scale only joins the key
+    // in adaptive mode, the only mode whose samples depend on it.
+    static std::uint64_t key_for(const GraphParams& p, double px_per_unit);
+
+    // Re-evaluate if `p` differs from the cached contents.  px_per_unit is
+    // the canvas scale.  Returns true if the samples were rebuilt.
+    bool update(const GraphParams& p, double px_per_unit = 0.0);
+
+    // Unconditionally re-evaluate.
+    void rebuild(const GraphParams& p, double px_per_unit);
+
+    void invalidate() { valid = false; }
+    std::size_t size() const { return xs.size(); }
+};
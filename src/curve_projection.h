@@ -0,0 +1,30 @@
+#pragma once
+
+#include "graph_params.h"
+
+#include <algorithm>
+
+// Maps model-space curve coordinates to pixels on a w×h canvas, laid out
+// the way GraphCanvas draws it: centred, with the larger amplitude plus 15%
+// headroom filling the inscribed square less a 10 px margin.  Pixel
+// coordinates are relative to the canvas origin, y pointing down.
+struct CurveProjection {
+    double cx   = 0.0;   // canvas centre
+    double cy   = 0.0;
+    int    half = 0;     // half-extent of the plotting square, pixels
+    double k    = 1.0;   // pixels per model unit
+
+    static CurveProjection fit(const GraphParams& p, int w, int h) {
+        double scale = std::max(p.A, p.B) * 1.15;
+        if (scale < 0.01) scale = 1.0;
+        CurveProjection pr;
+        pr.cx   = w / 2;
+        pr.cy   = h / 2;
+        pr.half = std::min(w, h) / 2 - 10;
+        pr.k    = pr.half / scale;
+        return pr;
+    }
+
+    double sx(double x) const { return cx + x * k; }
+    double sy(double y) const { return cy - y * k; }
+};
@@ -0,0 +1,27 @@
+#include "curve_stream.h"
+
+#include <algorithm>
+#include <vector>
+
+bool stream_curve(const GraphParams& p, const SamplePlan& plan,
+                  const CurveProjection& proj, PolylineDecimator& out,
+                  const std::function<bool()>& cancelled)
+{
+    const std::size_t chunk = std::min(kStreamChunk, std::max<std::size_t>(plan.count, 1));
+    std::vector<double> xs(chunk), ys(chunk);
+
+    out.reset();
+    double dt = plan.count > 1
+              ? (plan.t1 - plan.t0) / static_cast<double>(plan.count - 1) : 0.0;
+    for (std::size_t start = 0; start < plan.count; start += chunk) {
+        if (cancelled && cancelled()) return false;
+        std::size_t len = std::min(chunk, plan.count - start);
+        double t0 = plan.t0 + dt * static_cast<double>(start);
+        double t1 = plan.t0 + dt * static_cast<double>(start + len - 1);
+        p.eval_range(t0, t1, len, xs.data(), ys.data());
+        for (std::size_t i = 0; i < len; ++i)
+            out.push(proj.sx(xs[i]), proj.sy(ys[i]));
+    }
+    out.finish();
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "curve_projection.h"
+#include "graph_params.h"
+#include "polyline_decimator.h"
+
+#include <cstddef>
+#include <functional>
+
+// Streaming evaluate → project → decimate pipeline for very dense curves.
+//
+// Samples plan.count points over [plan.t0, plan.t1] in chunks of
+// kStreamChunk, projects each chunk with `proj` and feeds it to `out`, so
+// memory stays O(kStreamChunk + output) however large the sample count is.
+// `out` is reset first.  Polls `cancelled` between chunks; returns false
+// if it fired.
+static constexpr std::size_t kStreamChunk = 16384;
+
+bool stream_curve(const GraphParams& p, const SamplePlan& plan,
+                  const CurveProjection& proj, PolylineDecimator& out,
+                  const std::function<bool()>& cancelled = {});
@@ -0,0 +1,88 @@
+#include "curve_worker.h"
+#include "curve_stream.h"
+
+#include <utility>
+
+CurveWorker::CurveWorker(ReadyCallback on_ready)
+    : on_ready_(std::move(on_ready)),
+      thread_(&CurveWorker::run, this) {}
+
+CurveWorker::~CurveWorker() {
+    stop();
+}
+
+void CurveWorker::stop() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        quit_ = true;
+        ++generation_;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+std::uint64_t CurveWorker::key_for(const GraphParams& p, int w, int h) {
+    std::uint64_t size = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(w)) << 32)
+                       | static_cast<std::uint32_t>(h);
+    return p.fingerprint() ^ (size * 0x9e3779b97f4a7c15ull);
+}
+
+void CurveWorker::request(const GraphParams& p, int w, int h) {
+    std::uint64_t key = key_for(p, w, h);
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (has_request_ && key == request_key_) return;
+        has_request_ = true;
+        request_key_ = key;
+        pending_     = p;
+        pending_w_   = w;
+        pending_h_   = h;
+        has_pending_ = true;
+        ++generation_;       // cancels the build in flight
+    }
+    cv_.notify_one();
+}
+
+void CurveWorker::run() {
+    for (;;) {
+        GraphParams   p;
+        int           w, h;
+        std::uint64_t gen;
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            cv_.wait(lk, [this] { return quit_ || has_pending_; });
+            if (quit_) return;
+            p   = pending_;
+            w   = pending_w_;
+            h   = pending_h_;
+            gen = generation_;
+            has_pending_ = false;
+        }
+
+        auto stale = [this, gen] { return generation_ != gen; };
+        CurveProjection proj = CurveProjection::fit(p, w, h);
+        SamplePlan plan = p.sample_plan();
+        std::size_t full = plan.count;
+
+        // Progressive refinement: preview pass, then the full sample count.
+        for (int pass = 0; pass < 2; ++pass) {
+            if (pass == 0 && full <= kPreviewPoints) continue;
+            plan.count = pass == 0 ? kPreviewPoints : full;
+            if (!stream_curve(p, plan, proj, back_.line, stale)) {
+                ++cancelled_;
+                break;
+            }
+            back_.key      = key_for(p, w, h);
+            back_.samples  = plan.count;
+            back_.valid    = true;
+            back_.complete = plan.count == full;
+            {
+                std::lock_guard<std::mutex> lk(front_mu_);
+                std::swap(front_, back_);
+            }
+            if (pass == 1) ++completed_;
+            if (on_ready_) on_ready_();
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "curve_projection.h"
+#include "graph_params.h"
+#include "polyline_decimator.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// A decimated, canvas-relative polyline produced by CurveWorker.
+struct ScreenCurve {
+    PolylineDecimator line;
+    std::uint64_t     key      = 0;       // CurveWorker::key_for() of the request
+    std::size_t       samples  = 0;       // samples streamed into `line`
+    bool              valid    = false;
+    bool              complete = false;   // false for a progressive preview
+};
+
+// Streams dense curves on a background thread so evaluation never blocks
+// the FLTK event loop, whatever num_points is.
+//
+// request() hands over a parameter snapshot and canvas size.  The worker
+// runs the evaluate → project → decimate pipeline (stream_curve) into its
+// back buffer, swaps that with the front buffer and calls `on_ready` (from
+// the worker thread — the callback must only post, e.g. Fl::awake).
+// Requests above kPreviewPoints are refined progressively: a preview pass
+// of kPreviewPoints samples is published first, then the full pass.
+// A newer request cancels the build in flight between chunks.
+class CurveWorker {
+public:
+    using ReadyCallback = std::function<void()>;
+
+    static constexpr std::size_t kPreviewPoints = 65536;
+
+    explicit CurveWorker(ReadyCallback on_ready);
+    ~CurveWorker();
+
+    CurveWorker(const CurveWorker&)            = delete;
+    CurveWorker& operator=(const CurveWorker&) = delete;
+
+    static std::uint64_t key_for(const GraphParams& p, int w, int h);
+
+    // Queue a build for a w×h canvas unless it matches the newest request.
+    void request(const GraphParams& p, int w, int h);
+
+    // Cancel the build in flight and join the worker; on_ready is not
+    // called once this returns.  Later requests are ignored.  Idempotent;
+    // the destructor calls it.
+    void stop();
+
+    // Run fn(const ScreenCurve&) on the newest published geometry while the
+    // worker is kept from swapping it out.
+    template <class Fn>
+    void with_front(Fn&& fn) {
+        std::lock_guard<std::mutex> lk(front_mu_);
+        fn(static_cast<const ScreenCurve&>(front_));
+    }
+
+    unsigned long completed() const { return completed_; }
+    unsigned long cancelled() const { return cancelled_; }
+
+private:
+    void run();
+
+    ReadyCallback on_ready_;
+
+    std::mutex              mu_;            // guards the request slot
+    std::condition_variable cv_;
+    GraphParams             pending_;
+    int                     pending_w_    = 0;
+    int                     pending_h_    = 0;
+    bool                    has_pending_  = false;
+    bool                    has_request_  = false;
+    std::uint64_t           request_key_  = 0;
+    bool                    quit_         = false;
+    std::atomic<std::uint64_t> generation_{0};
+
+    std::mutex  front_mu_;
+    ScreenCurve front_;
+    ScreenCurve back_;                      // worker thread only
+
+    std::atomic<unsigned long> completed_{0};
+    std::atomic<unsigned long> cancelled_{0};
+
+    std::thread thread_;                    // last: starts once all else is set
+};
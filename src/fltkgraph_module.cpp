@@ -0,0 +1,470 @@
+#include "fltkgraph_module.h"
+#include "graph_raster.h"
+#include "param_sweep.h"
+#include "py_args.h"
+#include "py_executor.h"
+#include "ui_thread.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ── fltkgraph module state ─────────────────────────────────────
+static constexpr const char* kGraphCapsule = "fltkgraph._graph";
+
+static GraphHandle g_handle;        // what the "_graph" capsule points at
+
+struct GraphModuleState {
+    PyObject* graph;                // the kGraphCapsule capsule
+};
+
+// The module's GraphHandle, or nullptr with RuntimeError set.  Touches
+// only Python state, so it runs on the interpreter thread.
+static GraphHandle* graph_handle(PyObject* module) {
+    auto* st = static_cast<GraphModuleState*>(PyModule_GetState(module));
+    auto* h  = st && st->graph
+             ? static_cast<GraphHandle*>(PyCapsule_GetPointer(st->graph, kGraphCapsule))
+             : nullptr;
+    if (!h && !PyErr_Occurred())
+        PyErr_SetString(PyExc_RuntimeError, "fltkgraph module has no graph handle");
+    return h;
+}
+
+// GraphParams and the window belong to the UI thread; the interpreter
+// runs on the PyExecutor thread.  Run fn there with the GIL released.
+// fn must not touch Python objects.  False with RuntimeError set once
+// the UI loop has stopped.
+static bool on_ui(const std::function<void()>& fn) {
+    bool ok;
+    Py_BEGIN_ALLOW_THREADS
+    ok = run_on_ui_thread(fn);
+    Py_END_ALLOW_THREADS
+    if (!ok) PyErr_SetString(PyExc_RuntimeError, "UI thread is not running");
+    return ok;
+}
+
+// Run fn(handle, live params) on the UI thread.  False with an exception
+// set if the module has no handle, there is no graph window, or the UI
+// loop has stopped.
+static bool with_graph(PyObject* module,
+                       const std::function<void(GraphHandle&, GraphParams&)>& fn) {
+    GraphHandle* h = graph_handle(module);
+    if (!h) return false;
+    bool have_window = false;
+    if (!on_ui([&] {
+            if (GraphParams* p = h->params()) { fn(*h, *p); have_window = true; }
+        }))
+        return false;
+    if (!have_window) {
+        PyErr_SetString(PyExc_RuntimeError, "graph window not available");
+        return false;
+    }
+    return true;
+}
+
+// Cancel predicate for a long call made with the GIL released: true once
+// the console's Ctrl+C (PyExecutor::interrupt) arrived.  Reads an atomic,
+// so pool threads may poll it too.  Empty off an executor thread.
+static std::function<bool()> interrupt_poll() {
+    const std::atomic<bool>* flag = PyExecutor::interrupt_flag();
+    if (!flag) return {};
+    return [flag] { return flag->load(std::memory_order_relaxed); };
+}
+
+// The call stopped for Ctrl+C: raise the KeyboardInterrupt now, in place
+// of the executor's asynchronous one.
+static PyObject* raise_interrupted() {
+    PyExecutor::consume_interrupt();
+    PyErr_SetNone(PyExc_KeyboardInterrupt);
+    return nullptr;
+}
+
+// Copy of the live parameters, taken on the UI thread.
+static bool snapshot(PyObject* module, GraphParams& out) {
+    return with_graph(module, [&](GraphHandle&, GraphParams& p) { out = p; });
+}
+
+// ── Python C-function wrappers for the graph ────────────────────
+
+// Resolve a parameter name; ValueError listing kParamDescs if unknown.
+static bool param_arg(const char* name, ParamId& id) {
+    if (GraphParams::param_id(name, id)) return true;
+    static const std::string msg = [] {
+        std::string m = "unknown parameter (";
+        for (const ParamDesc& d : kParamDescs) {
+            if (&d != kParamDescs) m += ", ";
+            m += d.name;
+        }
+        return m + ")";
+    }();
+    PyErr_SetString(PyExc_ValueError, msg.c_str());
+    return false;
+}
+
+static PyObject* py_graph_set(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    const char* param; double value; ParamId id;
+    if (!py_nargs("graph_set", nargs, 2, 2) || !py_arg_str(args[0], param) ||
+        !py_arg_double(args[1], value) || !param_arg(param, id)) return nullptr;
+    if (!with_graph(self, [&](GraphHandle& g, GraphParams& p) {
+            p.set(id, value);
+            g.changed(true);
+        }))
+        return nullptr;
+    Py_RETURN_NONE;
+}
+
+static PyObject* py_graph_get(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    const char* param; ParamId id;
+    if (!py_nargs("graph_get", nargs, 1, 1) || !py_arg_str(args[0], param) ||
+        !param_arg(param, id)) return nullptr;
+    double v = 0.0;
+    if (!with_graph(self, [&](GraphHandle&, GraphParams& p) { v = p.get(id); }))
+        return nullptr;
+    return PyFloat_FromDouble(v);
+}
+
+static PyObject* py_graph_params(PyObject* self, PyObject*) {
+    std::array<ParamValue, kParamCount> values;
+    if (!with_graph(self, [&](GraphHandle&, GraphParams& p) { values = p.values(); }))
+        return nullptr;
+    PyObject* dict = PyDict_New();
+    for (const ParamValue& pv : values) {
+        PyObject* fval = PyFloat_FromDouble(pv.value);
+        PyDict_SetItemString(dict, pv.name, fval);
+        Py_DECREF(fval);
+    }
+    return dict;
+}
+
+static PyObject* py_graph_preset(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    const char* name;
+    if (!py_nargs("graph_preset", nargs, 1, 1) || !py_arg_str(args[0], name)) return nullptr;
+    bool known = false;
+    if (!with_graph(self, [&](GraphHandle& g, GraphParams& p) {
+            if ((known = p.load_preset(name))) g.changed(true);
+        }))
+        return nullptr;
+    if (!known) {
+        PyErr_SetString(PyExc_ValueError, "unknown preset (circle, figure8, lissajous, star, bowtie)");
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* py_graph_eval(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    double t;
+    if (!py_nargs("graph_eval", nargs, 1, 1) || !py_arg_double(args[0], t)) return nullptr;
+    double px = 0.0, py = 0.0;
+    if (!with_graph(self, [&](GraphHandle&, GraphParams& p) { std::tie(px, py) = p.eval(t); }))
+        return nullptr;
+    PyObject* xy = PyTuple_New(2);
+    if (!xy) return nullptr;
+    PyTuple_SET_ITEM(xy, 0, PyFloat_FromDouble(px));
+    PyTuple_SET_ITEM(xy, 1, PyFloat_FromDouble(py));
+    return xy;
+}
+
+void eval_interleaved(const GraphParams& p, double t0, double t1,
+                      std::size_t n, double* out)
+{
+    constexpr std::size_t kChunk = 4096;
+    std::vector<double> xs(std::min(kChunk, n)), ys(xs.size());
+    double dt = n > 1 ? (t1 - t0) / static_cast<double>(n - 1) : 0.0;
+    for (std::size_t start = 0; start < n; start += kChunk) {
+        std::size_t len = std::min(kChunk, n - start);
+        p.eval_range(t0 + dt * static_cast<double>(start),
+                     t0 + dt * static_cast<double>(start + len - 1), len, xs.data(), ys.data());
+        for (std::size_t i = 0; i < len; ++i) {
+            out[2 * (start + i)]     = xs[i];
+            out[2 * (start + i) + 1] = ys[i];
+        }
+    }
+}
+
+// True for struct formats describing one native double ("d", "@d", "=d", "<d" on LE).
+static bool is_double_format(const char* fmt) {
+    if (!fmt) return false;                     // NULL means unsigned bytes
+    if (fmt[0] == 'd' && fmt[1] == '\0') return true;
+    return fmt[0] != '\0' && fmt[1] == 'd' && fmt[2] == '\0' &&
+           (fmt[0] == '@' || fmt[0] == '=' || fmt[0] == (PY_LITTLE_ENDIAN ? '<' : '>'));
+}
+
+static PyObject* py_graph_eval_many(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    Py_ssize_t n; double t0 = 0.0, t1 = 2.0 * M_PI;
+    if (!py_nargs("graph_eval_many", nargs, 1, 3) || !py_arg_ssize(args[0], n) ||
+        (nargs > 1 && !py_arg_double(args[1], t0)) ||
+        (nargs > 2 && !py_arg_double(args[2], t1))) return nullptr;
+    if (n < 0 || n > GraphParams::kMaxPoints) {
+        PyErr_Format(PyExc_ValueError, "n must be between 0 and %d", GraphParams::kMaxPoints);
+        return nullptr;
+    }
+
+    GraphParams p;
+    if (!snapshot(self, p)) return nullptr;
+
+    PyObject* bytes = PyByteArray_FromStringAndSize(nullptr, n * 2 * Py_ssize_t(sizeof(double)));
+    if (!bytes) return nullptr;
+    auto* out = reinterpret_cast<double*>(PyByteArray_AS_STRING(bytes));
+    Py_BEGIN_ALLOW_THREADS
+    eval_interleaved(p, t0, t1, static_cast<std::size_t>(n), out);
+    Py_END_ALLOW_THREADS
+
+    PyObject* raw = PyMemoryView_FromObject(bytes);
+    Py_DECREF(bytes);
+    if (!raw) return nullptr;
+    PyObject* mv = PyObject_CallMethod(raw, "cast", "s", "d");
+    Py_DECREF(raw);
+    return mv;
+}
+
+static PyObject* py_graph_eval_into(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    double t0 = 0.0, t1 = 2.0 * M_PI;
+    if (!py_nargs("graph_eval_into", nargs, 1, 3) ||
+        (nargs > 1 && !py_arg_double(args[1], t0)) ||
+        (nargs > 2 && !py_arg_double(args[2], t1))) return nullptr;
+    PyObject* target = args[0];
+    GraphParams p;
+    if (!snapshot(self, p)) return nullptr;
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(target, &view, PyBUF_WRITABLE | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) != 0)
+        return nullptr;
+    if (view.itemsize != sizeof(double) || !is_double_format(view.format)) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_TypeError, "buffer must hold doubles (format 'd')");
+        return nullptr;
+    }
+    std::size_t n = static_cast<std::size_t>(view.len) / (2 * sizeof(double));
+    auto* out = static_cast<double*>(view.buf);
+    Py_BEGIN_ALLOW_THREADS
+    eval_interleaved(p, t0, t1, n, out);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&view);
+    return PyLong_FromSize_t(n);
+}
+
+static PyObject* py_graph_sampling(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    const char* mode = nullptr;
+    if (!py_nargs("graph_sampling", nargs, 0, 1) ||
+        (nargs > 0 && !py_arg_str(args[0], mode))) return nullptr;
+    bool known = true;
+    const char* current = nullptr;
+    if (!with_graph(self, [&](GraphHandle& g, GraphParams& p) {
+            if (mode && (known = p.set_sampling(mode))) g.changed(false);
+            current = p.sampling_name();
+        }))
+        return nullptr;
+    if (!known) {
+        PyErr_SetString(PyExc_ValueError, "unknown sampling mode (uniform, adaptive)");
+        return nullptr;
+    }
+    return PyUnicode_FromString(current);
+}
+
+static PyObject* py_graph_engine(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    const char* name = nullptr;
+    if (!py_nargs("graph_engine", nargs, 0, 1) ||
+        (nargs > 0 && !py_arg_str(args[0], name))) return nullptr;
+    bool known = true;
+    const char* current = nullptr;
+    if (!with_graph(self, [&](GraphHandle& g, GraphParams& p) {
+            if (name && (known = p.set_engine(name))) g.changed(false);
+            current = p.engine_name();
+        }))
+        return nullptr;
+    if (!known) {
+        PyErr_SetString(PyExc_ValueError, "unknown engine (simd, recurrence)");
+        return nullptr;
+    }
+    return PyUnicode_FromString(current);
+}
+
+static PyObject* py_graph_stats(PyObject* self, PyObject*) {
+    FrameStats st{};
+    if (!with_graph(self, [&](GraphHandle& g, GraphParams&) { st = g.frame_stats(); }))
+        return nullptr;
+    return Py_BuildValue("{s:k,s:k,s:k,s:k}",
+                         "requests", st.requests, "merged", st.merged,
+                         "frames", st.frames, "dropped", st.dropped);
+}
+
+static PyObject* py_graph_render(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    const char* path; int w, h;
+    if (!py_nargs("graph_render", nargs, 3, 3) || !py_arg_str(args[0], path) ||
+        !py_arg_int(args[1], w) || !py_arg_int(args[2], h)) return nullptr;
+    GraphParams p;
+    if (!snapshot(self, p)) return nullptr;
+    std::function<bool()> cancelled = interrupt_poll();
+    RgbaImage img;
+    Py_BEGIN_ALLOW_THREADS
+    img = render_graph(p, w, h, cancelled);
+    Py_END_ALLOW_THREADS
+    if (img.px.empty() && cancelled && cancelled()) return raise_interrupted();
+    if (img.px.empty()) { PyErr_SetString(PyExc_ValueError, "image size out of range"); return nullptr; }
+    if (!write_image(img, path)) { PyErr_SetFromErrnoWithFilename(PyExc_OSError, path); return nullptr; }
+    Py_RETURN_NONE;
+}
+
+// A sweep range is a number or a (lo, hi, steps) sequence.
+static bool get_sweep_range(PyObject* obj, SweepRange& r) {
+    if (!obj) return true;
+    if (PyNumber_Check(obj)) {
+        r.lo = r.hi = PyFloat_AsDouble(obj);
+        r.steps = 1;
+        return !PyErr_Occurred();
+    }
+    PyObject* seq = PySequence_Tuple(obj);
+    if (!seq) return false;
+    bool ok = PyArg_ParseTuple(seq, "ddi", &r.lo, &r.hi, &r.steps);
+    Py_DECREF(seq);
+    if (!ok) return false;
+    if (r.steps < 1) { PyErr_SetString(PyExc_ValueError, "sweep steps must be >= 1"); return false; }
+    return true;
+}
+
+static PyObject* py_graph_sweep(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static const char* kwlist[] = {"a", "b", "A", "B", "delta",
+                                   "reduce", "points", "threads", nullptr};
+    PyObject *a = nullptr, *b = nullptr, *A = nullptr, *B = nullptr, *delta = nullptr;
+    const char* reduce = "bbox";
+    int points = 0, threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|$OOOOOsii", const_cast<char**>(kwlist),
+                                     &a, &b, &A, &B, &delta, &reduce, &points, &threads))
+        return nullptr;
+    GraphParams current;
+    if (!snapshot(self, current)) return nullptr;
+
+    SweepSpec spec = SweepSpec::around(current);
+    if (!get_sweep_range(a, spec.a) || !get_sweep_range(b, spec.b) ||
+        !get_sweep_range(A, spec.A) || !get_sweep_range(B, spec.B) ||
+        !get_sweep_range(delta, spec.delta))
+        return nullptr;
+    if (!parse_reducer(reduce, spec.reducer)) {
+        PyErr_SetString(PyExc_ValueError, "unknown reducer (bbox, arclength, selfintersections)");
+        return nullptr;
+    }
+    if (points > 0) spec.base.set(ParamId::points, points);
+    if (threads < 0 || threads > static_cast<int>(SweepSpec::kMaxThreads)) {
+        PyErr_Format(PyExc_ValueError, "threads must be between 0 and %u", SweepSpec::kMaxThreads);
+        return nullptr;
+    }
+    spec.threads = static_cast<unsigned>(threads);
+    if (spec.combinations() > SweepSpec::kMaxCombinations) {
+        PyErr_SetString(PyExc_ValueError, "too many sweep combinations");
+        return nullptr;
+    }
+
+    std::function<bool()> cancelled = interrupt_poll();
+    std::vector<SweepResult> results;
+    Py_BEGIN_ALLOW_THREADS
+    results = run_sweep(spec, cancelled);
+    Py_END_ALLOW_THREADS
+    if (results.empty() && cancelled && cancelled()) return raise_interrupted();
+
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(results.size()));
+    if (!list) return nullptr;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const SweepResult& r = results[i];
+        PyObject* d = nullptr;
+        switch (spec.reducer) {
+        case SweepReducer::bbox:
+            d = Py_BuildValue("{s:d,s:d,s:d,s:d,s:d,s:d,s:d,s:d,s:d}",
+                              "a", r.a, "b", r.b, "A", r.A, "B", r.B, "delta", r.delta,
+                              "xmin", r.xmin, "xmax", r.xmax, "ymin", r.ymin, "ymax", r.ymax);
+            break;
+        case SweepReducer::arclength:
+            d = Py_BuildValue("{s:d,s:d,s:d,s:d,s:d,s:d}",
+                              "a", r.a, "b", r.b, "A", r.A, "B", r.B, "delta", r.delta,
+                              "length", r.length);
+            break;
+        case SweepReducer::selfintersections:
+            d = Py_BuildValue("{s:d,s:d,s:d,s:d,s:d,s:l}",
+                              "a", r.a, "b", r.b, "A", r.A, "B", r.B, "delta", r.delta,
+                              "crossings", r.crossings);
+            break;
+        }
+        if (!d) { Py_DECREF(list); return nullptr; }
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), d);
+    }
+    return list;
+}
+
+static PyObject* launch_plugin(PyObject* module, bool tk) {
+    GraphHandle* h = graph_handle(module);
+    if (!h || !on_ui([&] { h->launch_plugin(tk); })) return nullptr;
+    Py_RETURN_NONE;
+}
+
+static PyObject* py_launch_tk(PyObject* self, PyObject*)      { return launch_plugin(self, true); }
+static PyObject* py_launch_tkinter(PyObject* self, PyObject*) { return launch_plugin(self, false); }
+
+static PyMethodDef graph_method_defs[] = {
+    {"graph_set",             PY_CFUNC(py_graph_set),       METH_FASTCALL, "graph_set('param', value)"},
+    {"graph_get",             PY_CFUNC(py_graph_get),       METH_FASTCALL, "graph_get('param')"},
+    {"graph_params",          py_graph_params,              METH_NOARGS,   "graph_params() -> dict"},
+    {"graph_preset",          PY_CFUNC(py_graph_preset),    METH_FASTCALL, "graph_preset('name')"},
+    {"graph_eval",            PY_CFUNC(py_graph_eval),      METH_FASTCALL, "graph_eval(t) -> (x,y)"},
+    {"graph_eval_many",       PY_CFUNC(py_graph_eval_many), METH_FASTCALL, "graph_eval_many(n, t0=0, t1=2*pi) -> memoryview of x0,y0,x1,y1,... doubles"},
+    {"graph_eval_into",       PY_CFUNC(py_graph_eval_into), METH_FASTCALL, "graph_eval_into(buf, t0=0, t1=2*pi) -> points written; buf holds 2 doubles per point"},
+    {"graph_sampling",        PY_CFUNC(py_graph_sampling),  METH_FASTCALL, "graph_sampling(['uniform'|'adaptive']) -> mode"},
+    {"graph_engine",          PY_CFUNC(py_graph_engine),    METH_FASTCALL, "graph_engine(['simd'|'recurrence']) -> engine"},
+    {"graph_stats",           py_graph_stats,               METH_NOARGS,   "graph_stats() -> dict of frame counters"},
+    {"graph_render",          PY_CFUNC(py_graph_render),    METH_FASTCALL, "graph_render('file.ppm'|'file.png', w, h)"},
+    {"graph_sweep",           PY_CFUNC(py_graph_sweep),     METH_VARARGS | METH_KEYWORDS,
+                              "graph_sweep(a=(lo,hi,n), ..., reduce='bbox'|'arclength'|'selfintersections', points=0, threads=0) -> list of dicts"},
+    {"launch_tk_plugin",      py_launch_tk,                 METH_NOARGS,   "Launch Tcl/Tk graph plugin"},
+    {"launch_tkinter_plugin", py_launch_tkinter,            METH_NOARGS,   "Launch tkinter graph plugin"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+// ── fltkgraph module ────────────────────────────────────────────
+static int fltkgraph_traverse(PyObject* m, visitproc visit, void* arg) {
+    auto* st = static_cast<GraphModuleState*>(PyModule_GetState(m));
+    if (st) Py_VISIT(st->graph);
+    return 0;
+}
+
+static int fltkgraph_clear(PyObject* m) {
+    auto* st = static_cast<GraphModuleState*>(PyModule_GetState(m));
+    if (st) Py_CLEAR(st->graph);
+    return 0;
+}
+
+static void fltkgraph_free(void* m) {
+    fltkgraph_clear(static_cast<PyObject*>(m));
+}
+
+static PyModuleDef fltkgraph_def = {
+    PyModuleDef_HEAD_INIT,
+    "fltkgraph",
+    "Parametric graph of the FLTK console app.",
+    sizeof(GraphModuleState),
+    graph_method_defs,
+    nullptr,
+    fltkgraph_traverse,
+    fltkgraph_clear,
+    fltkgraph_free,
+};
+
+static PyObject* PyInit_fltkgraph() {
+    PyObject* m = PyModule_Create(&fltkgraph_def);
+    if (!m) return nullptr;
+    auto* st  = static_cast<GraphModuleState*>(PyModule_GetState(m));
+    st->graph = PyCapsule_New(&g_handle, kGraphCapsule, nullptr);
+    if (!st->graph || PyModule_AddObjectRef(m, "_graph", st->graph) < 0) {
+        Py_DECREF(m);
+        return nullptr;
+    }
+    return m;
+}
+
+bool fltkgraph_register(const GraphHandle& handle) {
+    g_handle = handle;
+    static bool appended = false;
+    if (!appended) appended = PyImport_AppendInittab("fltkgraph", PyInit_fltkgraph) == 0;
+    return appended;
+}
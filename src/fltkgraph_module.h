@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Python.h>   // must come first on some platforms
+
+#include "graph_handle.h"
+
+#include <cstddef>
+
+// The embedded "fltkgraph" Python module: graph_set/get/eval/..., backed
+// by a GraphHandle the host supplies and shared as the "fltkgraph._graph"
+// capsule.  No GUI dependency, so the bindings can be exercised without a
+// window.
+
+// Back the module with `handle` and add it to the builtin inittab (once).
+// Call before Py_Initialize.  False if the inittab could not be extended.
+bool fltkgraph_register(const GraphHandle& handle);
+
+// Evaluate n evenly spaced points of p on [t0, t1] into out as
+// x0 y0 x1 y1 ...; what graph_eval_many/graph_eval_into write.  Runs in
+// chunks through SoA scratch and touches no Python objects.
+void eval_interleaved(const GraphParams& p, double t0, double t1,
+                      std::size_t n, double* out);
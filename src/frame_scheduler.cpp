@@ -0,0 +1,38 @@
+#include "frame_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+double FrameScheduler::request(double now) {
+    ++stats_.requests;
+    if (pending_) {
+        ++stats_.merged;
+        return -1.0;
+    }
+    pending_ = true;
+    return std::max(0.0, last_flush_ + interval_ - now);
+}
+
+bool FrameScheduler::flush(double now, std::uint64_t key) {
+    pending_    = false;
+    last_flush_ = now;
+    if (has_key_ && key == last_key_) {
+        ++stats_.dropped;
+        return false;
+    }
+    has_key_  = true;
+    last_key_ = key;
+    ++stats_.frames;
+    return true;
+}
+
+void FrameScheduler::flush(double now) {
+    pending_    = false;
+    last_flush_ = now;
+    ++stats_.frames;
+}
+
+double frame_clock_now() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
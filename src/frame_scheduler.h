@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+// Counters reported by FrameScheduler.
+struct FrameStats {
+    unsigned long requests = 0;   // update requests received
+    unsigned long merged   = 0;   // requests folded into an already-pending frame
+    unsigned long frames   = 0;   // frames flushed
+    unsigned long dropped  = 0;   // frames skipped: nothing changed since the last one
+};
+
+// Frame pacing for bursts of parameter updates.  Pure bookkeeping: the owner
+// arms a timer for the delay returned by request() and calls flush() when it
+// fires.  Every request that arrives while a frame is pending is merged into
+// it, and frames are spaced at least 1/fps apart.  Times are in seconds.
+class FrameScheduler {
+public:
+    explicit FrameScheduler(double fps = 60.0) : interval_(1.0 / fps) {}
+
+    // Record a request made at `now`.  Returns the delay until the frame
+    // should be flushed, or a negative value if one is already pending.
+    double request(double now);
+
+    // Flush the pending frame at `now`.  `key` identifies the state being
+    // shown (e.g. GraphParams::fingerprint()); returns false — and counts
+    // the frame as dropped — if it matches the previous frame.
+    bool flush(double now, std::uint64_t key);
+
+    // Flush the pending frame at `now` with no drop check, for owners whose
+    // frames always carry new content (e.g. queued console output).
+    void flush(double now);
+
+    bool pending() const { return pending_; }
+    const FrameStats& stats() const { return stats_; }
+
+private:
+    double        interval_;
+    double        last_flush_ = -1e300;
+    bool          pending_    = false;
+    bool          has_key_    = false;
+    std::uint64_t last_key_   = 0;
+    FrameStats    stats_;
+};
+
+// Monotonic clock in seconds, for FrameScheduler callers.
+double frame_clock_now();
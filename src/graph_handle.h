@@ -0,0 +1,18 @@
+#pragma once
+
+#include "frame_scheduler.h"
+#include "graph_params.h"
+
+// C-level handle on the graph for the console bindings (the Tcl `graph`
+// command and the fltkgraph Python module).  The interpreters run on
+// worker threads while the parameters and window belong to the UI thread,
+// so the handle holds no raw GraphParams*: its functions resolve the live
+// graph and may only be called on the UI thread (through
+// run_on_ui_thread()).  The app's handle is graph_window_handle(); tests
+// supply their own.
+struct GraphHandle {
+    GraphParams* (*params)();          // the graph window's live parameters, or nullptr
+    void (*changed)(bool show);        // schedule a redraw, optionally raising the window
+    FrameStats (*frame_stats)();       // the window's frame counters
+    void (*launch_plugin)(bool tk);    // Tk (true) or Tkinter (false) slider plugin
+};
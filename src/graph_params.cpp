@@ -1,24 +1,109 @@
 #include "graph_params.h"
+#include "sine_kernel.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+// ── Name lookup ─────────────────────────────────────────────────
+// The first characters a, b, d, p, A, B land in distinct slots once the
+// ASCII case bit is folded into bit 3, so one probe and one compare
+// identify a name.
+static constexpr std::size_t kParamSlotCount = 16;
+
+static constexpr std::size_t param_slot(char c) {
+    auto u = static_cast<unsigned char>(c);
+    return (u & 7u) | ((u >> 2) & 8u);
+}
+
+static constexpr std::array<signed char, kParamSlotCount> kParamSlots = [] {
+    std::array<signed char, kParamSlotCount> slots{};
+    for (auto& s : slots) s = -1;
+    for (std::size_t i = 0; i < kParamCount; ++i)
+        slots[param_slot(kParamDescs[i].name[0])] = static_cast<signed char>(i);
+    return slots;
+}();
+
+static constexpr bool param_hash_is_perfect() {
+    for (std::size_t i = 0; i < kParamCount; ++i)
+        if (kParamSlots[param_slot(kParamDescs[i].name[0])] != static_cast<signed char>(i))
+            return false;
+    return true;
+}
+static_assert(param_hash_is_perfect(), "two parameter names share a hash slot");
+
+static constexpr bool descs_in_id_order() {
+    for (std::size_t i = 0; i < kParamCount; ++i)
+        if (static_cast<std::size_t>(kParamDescs[i].id) != i) return false;
+    return true;
+}
+static_assert(descs_in_id_order(), "kParamDescs must be listed in ParamId order");
+
+bool GraphParams::param_id(const std::string& name, ParamId& id) {
+    if (name.empty()) return false;
+    int i = kParamSlots[param_slot(name[0])];
+    if (i < 0 || name != kParamDescs[i].name) return false;
+    id = kParamDescs[i].id;
+    return true;
+}
+
+void GraphParams::set(ParamId id, double value) {
+    const ParamDesc& d = param_desc(id);
+    value = std::clamp(value, d.min, d.max);
+    switch (id) {
+    case ParamId::a:      a = value;     break;
+    case ParamId::b:      b = value;     break;
+    case ParamId::A:      A = value;     break;
+    case ParamId::B:      B = value;     break;
+    case ParamId::delta:  delta = value; break;
+    case ParamId::points: num_points = static_cast<int>(value); break;
+    }
+}
+
+double GraphParams::get(ParamId id) const {
+    switch (id) {
+    case ParamId::a:      return a;
+    case ParamId::b:      return b;
+    case ParamId::A:      return A;
+    case ParamId::B:      return B;
+    case ParamId::delta:  return delta;
+    case ParamId::points: return num_points;
+    }
+    return NAN;
+}
 
 bool GraphParams::set(const std::string& name, double value) {
-    if      (name == "a")      a = value;
-    else if (name == "b")      b = value;
-    else if (name == "A")      A = value;
-    else if (name == "B")      B = value;
-    else if (name == "delta")  delta = value;
-    else if (name == "points") num_points = static_cast<int>(value);
-    else return false;
+    ParamId id;
+    if (!param_id(name, id)) return false;
+    set(id, value);
     return true;
 }
 
 double GraphParams::get(const std::string& name) const {
-    if (name == "a")      return a;
-    if (name == "b")      return b;
-    if (name == "A")      return A;
-    if (name == "B")      return B;
-    if (name == "delta")  return delta;
-    if (name == "points") return num_points;
-    return NAN;
+    ParamId id;
+    return param_id(name, id) ? get(id) : NAN;
+}
+
+bool GraphParams::set_sampling(const std::string& name) {
+    if      (name == "uniform")  sampling = Sampling::uniform;
+    else if (name == "adaptive") sampling = Sampling::adaptive;
+    else return false;
+    return true;
+}
+
+const char* GraphParams::sampling_name() const {
+    return sampling == Sampling::adaptive ? "adaptive" : "uniform";
+}
+
+bool GraphParams::set_engine(const std::string& name) {
+    if      (name == "simd")       engine = EvalEngine::simd;
+    else if (name == "recurrence") engine = EvalEngine::recurrence;
+    else return false;
+    return true;
+}
+
+const char* GraphParams::engine_name() const {
+    return engine == EvalEngine::recurrence ? "recurrence" : "simd";
 }
 
 bool GraphParams::load_preset(const std::string& name) {
@@ -38,9 +123,120 @@ bool GraphParams::load_preset(const std::string& name) {
     return true;
 }
 
-std::map<std::string, double> GraphParams::all() const {
-    return {
-        {"a", a}, {"b", b}, {"A", A}, {"B", B},
-        {"delta", delta}, {"points", static_cast<double>(num_points)}
+std::array<ParamValue, kParamCount> GraphParams::values() const {
+    std::array<ParamValue, kParamCount> out;
+    for (std::size_t i = 0; i < kParamCount; ++i)
+        out[i] = {kParamDescs[i].id, kParamDescs[i].name, get(kParamDescs[i].id)};
+    return out;
+}
+
+// Best rational approximation p/q of x >= 0 with q <= max_den, via
+// continued fractions.  Returns false if none is within 1e-9.
+static bool as_rational(double x, long long max_den, long long& p, long long& q) {
+    long long p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    double r = x;
+    for (int iter = 0; iter < 40; ++iter) {
+        double fl = std::floor(r);
+        if (fl > 1e9) break;
+        long long c  = static_cast<long long>(fl);
+        long long p2 = c * p1 + p0;
+        long long q2 = c * q1 + q0;
+        if (q2 > max_den) break;
+        p0 = p1; q0 = q1; p1 = p2; q1 = q2;
+        if (std::fabs(x - static_cast<double>(p1) / q1) <= 1e-9 * std::max(1.0, x)) {
+            p = p1; q = q1;
+            return true;
+        }
+        double frac = r - fl;
+        if (frac < 1e-12) break;
+        r = 1.0 / frac;
+    }
+    return false;
+}
+
+SamplePlan GraphParams::sample_plan(bool dense) const {
+    SamplePlan plan;
+    std::size_t budget = static_cast<std::size_t>(std::max(num_points, 1));
+    plan.count = budget + 1;
+
+    long long pa, qa, pb, qb;
+    if (!as_rational(std::fabs(a), 1000, pa, qa) ||
+        !as_rational(std::fabs(b), 1000, pb, qb))
+        return plan;
+
+    // gcd(pa/qa, pb/qb) = gcd(pa*qb, pb*qa) / (qa*qb); the curve closes
+    // after 2π divided by that.  It tiles [0, 2π] only if it is an integer.
+    long long g_num = std::gcd(pa * qb, pb * qa);
+    long long g_den = qa * qb;
+    if (g_num == 0 || g_num % g_den != 0) return plan;
+    long long periods = g_num / g_den;
+    if (periods <= 1) return plan;
+
+    plan.periods = static_cast<int>(periods);
+    plan.t1      = 2.0 * M_PI / static_cast<double>(periods);
+    plan.count   = dense ? budget + 1
+                         : std::max<std::size_t>(budget / periods, 1) + 1;
+    return plan;
+}
+
+// FNV-1a over the raw bytes of each field.
+std::uint64_t GraphParams::fingerprint() const {
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    auto mix = [&h](const void* p, std::size_t n) {
+        const auto* bytes = static_cast<const unsigned char*>(p);
+        for (std::size_t i = 0; i < n; ++i) {
+            h ^= bytes[i];
+            h *= 0x100000001b3ull;
+        }
     };
+    mix(&a, sizeof(a));
+    mix(&b, sizeof(b));
+    mix(&A, sizeof(A));
+    mix(&B, sizeof(B));
+    mix(&delta, sizeof(delta));
+    mix(&num_points, sizeof(num_points));
+    mix(&sampling, sizeof(sampling));
+    mix(&engine, sizeof(engine));
+    return h;
+}
+
+void GraphParams::eval_range(double t0, double t1, std::size_t count,
+                             double* xs, double* ys) const {
+    if (count == 0) return;
+    double dt = count > 1 ? (t1 - t0) / static_cast<double>(count - 1) : 0.0;
+    if (engine == EvalEngine::recurrence) {
+        sin_sequence(a * t0 + delta, a * dt, count, xs);
+        sin_sequence(b * t0, b * dt, count, ys);
+        for (std::size_t i = 0; i < count; ++i) {
+            xs[i] *= A;
+            ys[i] *= B;
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        double t = t0 + dt * static_cast<double>(i);
+        xs[i] = a * t + delta;
+        ys[i] = b * t;
+    }
+    sin_batch(xs, xs, count);
+    sin_batch(ys, ys, count);
+    for (std::size_t i = 0; i < count; ++i) {
+        xs[i] *= A;
+        ys[i] *= B;
+    }
+}
+
+void GraphParams::eval_many(const double* ts, std::size_t count,
+                            double* xs, double* ys) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        double t = ts[i];
+        xs[i] = a * t + delta;
+        ys[i] = b * t;
+    }
+    sin_batch(xs, xs, count);
+    sin_batch(ys, ys, count);
+    for (std::size_t i = 0; i < count; ++i) {
+        xs[i] *= A;
+        ys[i] *= B;
+    }
 }
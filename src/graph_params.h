@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
 #include <cmath>
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <utility>
 
@@ -9,30 +12,153 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+// Sampling window for one rendering of the curve: `count` evenly spaced
+// samples on [t0, t1], both ends included.
+struct SamplePlan {
+    double      t0      = 0.0;
+    double      t1      = 2.0 * M_PI;
+    std::size_t count   = 0;
+    int         periods = 1;    // closed-curve periods contained in [0, 2π]
+};
+
+// How the curve is sampled for drawing.
+enum class Sampling {
+    uniform,    // sample_plan(): evenly spaced t, num_points per window
+    adaptive,   // sample_adaptive(): curvature-driven, screen-space error bound
+};
+
+// Which kernel eval_range() uses.
+enum class EvalEngine {
+    simd,         // sin_batch(): vectorized polynomial sine
+    recurrence,   // sin_sequence(): rotation recurrence (opt-in, fastest)
+};
+
+// Numeric parameters addressable without a string lookup, in slider order.
+enum class ParamId { a, b, delta, A, B, points };
+
+// Static description of one parameter: its console name, the range and
+// step of its GraphWindow slider, and the range set() clamps to.  The two
+// ranges are independent: the slider covers the useful interactive span,
+// the console may go further.  A `log` slider moves in log10(value) (its
+// step is in those units), so each decade gets the same travel: points
+// spans 100..1e7 that way, where a linear slider would put ~30k points
+// under each pixel.
+struct ParamDesc {
+    ParamId     id;
+    const char* name;
+    double      lo, hi, step;   // slider
+    double      min, max;       // set()
+    bool        log = false;    // slider in log10 units, integer values
+};
+
+inline constexpr double kUnbounded = std::numeric_limits<double>::infinity();
+
+// One row per ParamId, in ParamId order.  Everything that lists parameters
+// (set/get, values(), the sliders, the Tcl and Python bindings) reads this.
+inline constexpr ParamDesc kParamDescs[] = {
+    {ParamId::a,      "a",      1.0, 10.0,     1.0,  -kUnbounded, kUnbounded},
+    {ParamId::b,      "b",      1.0, 10.0,     1.0,  -kUnbounded, kUnbounded},
+    {ParamId::delta,  "delta",  0.0, 2 * M_PI, 0.01, -kUnbounded, kUnbounded},
+    {ParamId::A,      "A",      0.1, 2.0,      0.05, -kUnbounded, kUnbounded},
+    {ParamId::B,      "B",      0.1, 2.0,      0.05, -kUnbounded, kUnbounded},
+    {ParamId::points, "points", 100, 1e7,      0.01, 1.0,         1e7,        true},
+};
+inline constexpr std::size_t kParamCount = std::size(kParamDescs);
+
+constexpr const ParamDesc& param_desc(ParamId id) {
+    return kParamDescs[static_cast<std::size_t>(id)];
+}
+
+// Slider position showing `value`, and the value at slider position `pos`.
+inline double slider_pos(const ParamDesc& d, double value) {
+    return d.log ? std::log10(value > d.lo ? value : d.lo) : value;
+}
+
+inline double slider_value(const ParamDesc& d, double pos) {
+    return d.log ? std::round(std::pow(10.0, pos)) : pos;
+}
+
+// One parameter's current value, as yielded by GraphParams::values().
+struct ParamValue {
+    ParamId     id;
+    const char* name;
+    double      value;
+};
+
 // Lissajous parametric curve parameters.
 // x(t) = A * sin(a*t + delta)
 // y(t) = B * sin(b*t)
 struct GraphParams {
+    // set(points) clamps to this.
+    static constexpr int kMaxPoints = static_cast<int>(param_desc(ParamId::points).max);
+
+    // Parameter names in ParamId order, nullptr-terminated (the layout
+    // Tcl_GetIndexFromObj expects).
+    static constexpr std::array<const char*, kParamCount + 1> kParamNames = [] {
+        std::array<const char*, kParamCount + 1> names{};
+        for (std::size_t i = 0; i < kParamCount; ++i) names[i] = kParamDescs[i].name;
+        return names;
+    }();
+
     double a     = 3.0;          // x frequency
     double b     = 2.0;          // y frequency
     double A     = 1.0;          // x amplitude
     double B     = 1.0;          // y amplitude
     double delta = M_PI / 2.0;   // phase shift
     int num_points = 1000;
+    Sampling sampling = Sampling::uniform;
+    EvalEngine engine = EvalEngine::simd;
 
     std::pair<double, double> eval(double t) const {
         return {A * std::sin(a * t + delta), B * std::sin(b * t)};
     }
 
+    // Batch evaluation into caller-provided structure-of-arrays output.
+    // eval_range samples `count` evenly spaced t values on [t0, t1], both
+    // ends included; eval_many evaluates at ts[0..count).  Both agree with
+    // eval() to ~1e-13.  eval_range honours `engine`; eval_many always uses
+    // the vectorized sin_batch kernel.
+    void eval_range(double t0, double t1, std::size_t count,
+                    double* xs, double* ys) const;
+    void eval_many(const double* ts, std::size_t count,
+                   double* xs, double* ys) const;
+
+    // Plan the samples for drawing [0, 2π].  When a/b is rational the curve
+    // closes after 2π/gcd(a, b); if that divides 2π, only one fundamental
+    // period is sampled.  With `dense` the whole num_points budget goes into
+    // that period, otherwise the per-period density is kept and fewer points
+    // are used.  Irrational ratios sample the full [0, 2π] as before.
+    SamplePlan sample_plan(bool dense = true) const;
+
     // Set a parameter by name.  Returns false if name is unknown.
     bool set(const std::string& name, double value);
+    void set(ParamId id, double value);
 
     // Get a parameter by name.  Returns NAN if unknown.
     double get(const std::string& name) const;
+    double get(ParamId id) const;
+
+    // Id of the parameter called `name`; false if unknown.  O(1): a perfect
+    // hash on the first character picks the only candidate.
+    static bool param_id(const std::string& name, ParamId& id);
+
+    // Select the sampling mode by name ("uniform" or "adaptive").
+    // Returns false if the name is unknown.
+    bool set_sampling(const std::string& name);
+    const char* sampling_name() const;
+
+    // Select the evaluation engine by name ("simd" or "recurrence").
+    // Returns false if the name is unknown.
+    bool set_engine(const std::string& name);
+    const char* engine_name() const;
 
     // Load a named preset.  Returns false if unknown.
     bool load_preset(const std::string& name);
 
-    // All parameters as a name→value map.
-    std::map<std::string, double> all() const;
+    // Every parameter with its current value, in ParamId order.
+    std::array<ParamValue, kParamCount> values() const;
+
+    // Hash of every field that affects the curve; used to key cached
+    // geometry so it is rebuilt only when a parameter really changes.
+    std::uint64_t fingerprint() const;
 };
@@ -0,0 +1,227 @@
+#include "graph_raster.h"
+#include "curve_buffer.h"
+#include "curve_projection.h"
+#include "curve_stream.h"
+#include "polyline_decimator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+
+// ── Colours (match GraphCanvas) ─────────────────────────────────
+struct Rgb { std::uint8_t r, g, b; };
+
+static constexpr Rgb kBackground = {12, 12, 22};
+static constexpr Rgb kGrid       = {30, 30, 45};
+static constexpr Rgb kAxes       = {70, 70, 90};
+static constexpr Rgb kCurve      = {0, 220, 120};
+static constexpr double kCurveHalfWidth = 1.0;   // 2 px, as on screen
+
+static void put(RgbaImage& img, int x, int y, Rgb c) {
+    std::uint8_t* p = img.at(x, y);
+    p[0] = c.r; p[1] = c.g; p[2] = c.b; p[3] = 255;
+}
+
+static void hline(RgbaImage& img, int y, Rgb c) {
+    if (y < 0 || y >= img.h) return;
+    for (int x = 0; x < img.w; ++x) put(img, x, y, c);
+}
+
+static void vline(RgbaImage& img, int x, Rgb c) {
+    if (x < 0 || x >= img.w) return;
+    for (int y = 0; y < img.h; ++y) put(img, x, y, c);
+}
+
+// Same integer layout as draw_grid() in graph_window.cpp.
+static void raster_grid(RgbaImage& img) {
+    for (int y = 0; y < img.h; ++y)
+        for (int x = 0; x < img.w; ++x) put(img, x, y, kBackground);
+
+    int cx   = img.w / 2;
+    int cy   = img.h / 2;
+    int half = std::min(img.w, img.h) / 2 - 10;
+    for (int i = -4; i <= 4; ++i) {
+        vline(img, cx + i * half / 4, kGrid);
+        hline(img, cy + i * half / 4, kGrid);
+    }
+    hline(img, cy, kAxes);
+    vline(img, cx, kAxes);
+}
+
+// ── Anti-aliased polyline ───────────────────────────────────────
+// Coverage of each pixel is the max over all segments of a 1 px ramp on
+// the distance to the segment, so joints and self-crossings don't
+// double-blend.  The mask is composited onto the image once at the end.
+static void cover_segment(std::vector<float>& mask, int w, int h,
+                          double ax, double ay, double bx, double by)
+{
+    const double reach = kCurveHalfWidth + 0.5;
+    int x0 = std::max(0,     static_cast<int>(std::floor(std::min(ax, bx) - reach)));
+    int x1 = std::min(w - 1, static_cast<int>(std::ceil (std::max(ax, bx) + reach)));
+    int y0 = std::max(0,     static_cast<int>(std::floor(std::min(ay, by) - reach)));
+    int y1 = std::min(h - 1, static_cast<int>(std::ceil (std::max(ay, by) + reach)));
+
+    double dx = bx - ax, dy = by - ay;
+    double len2 = dx * dx + dy * dy;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            double u = len2 > 0.0 ? ((x - ax) * dx + (y - ay) * dy) / len2 : 0.0;
+            u = std::min(1.0, std::max(0.0, u));
+            double d = std::hypot(ax + u * dx - x, ay + u * dy - y);
+            double c = reach - d;
+            if (c <= 0.0) continue;
+            float& m = mask[std::size_t(y) * w + x];
+            m = std::max(m, static_cast<float>(std::min(c, 1.0)));
+        }
+    }
+}
+
+static void raster_curve(RgbaImage& img, const PolylineDecimator& line) {
+    std::vector<float> mask(std::size_t(img.w) * img.h, 0.0f);
+    const auto& xs = line.xs();
+    const auto& ys = line.ys();
+    for (std::size_t i = 1; i < xs.size(); ++i)
+        cover_segment(mask, img.w, img.h, xs[i - 1], ys[i - 1], xs[i], ys[i]);
+
+    for (int y = 0; y < img.h; ++y) {
+        for (int x = 0; x < img.w; ++x) {
+            float a = mask[std::size_t(y) * img.w + x];
+            if (a <= 0.0f) continue;
+            std::uint8_t* p = img.at(x, y);
+            p[0] = static_cast<std::uint8_t>(std::lround(p[0] + (kCurve.r - p[0]) * a));
+            p[1] = static_cast<std::uint8_t>(std::lround(p[1] + (kCurve.g - p[1]) * a));
+            p[2] = static_cast<std::uint8_t>(std::lround(p[2] + (kCurve.b - p[2]) * a));
+        }
+    }
+}
+
+RgbaImage render_graph(const GraphParams& p, int w, int h,
+                       const std::function<bool()>& cancelled)
+{
+    if (w < 1 || h < 1 || w > kMaxRenderSize || h > kMaxRenderSize) return {};
+
+    RgbaImage img(w, h);
+    raster_grid(img);
+
+    CurveProjection proj = CurveProjection::fit(p, w, h);
+    PolylineDecimator line;
+    if (p.sampling == Sampling::uniform) {
+        if (!stream_curve(p, p.sample_plan(), proj, line, cancelled)) return {};
+    } else {
+        CurveBuffer cb;
+        cb.update(p, proj.k);
+        for (std::size_t i = 0; i < cb.size(); ++i)
+            line.push(proj.sx(cb.xs[i]), proj.sy(cb.ys[i]));
+        line.finish();
+        if (cancelled && cancelled()) return {};
+    }
+    raster_curve(img, line);
+    return img;
+}
+
+// ── PPM ─────────────────────────────────────────────────────────
+bool write_ppm(const RgbaImage& img, const std::string& path) {
+    if (img.px.empty()) return false;
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    std::fprintf(f, "P6\n%d %d\n255\n", img.w, img.h);
+    std::vector<std::uint8_t> row(std::size_t(img.w) * 3);
+    bool ok = true;
+    for (int y = 0; y < img.h && ok; ++y) {
+        for (int x = 0; x < img.w; ++x) {
+            const std::uint8_t* p = img.at(x, y);
+            row[x * 3 + 0] = p[0];
+            row[x * 3 + 1] = p[1];
+            row[x * 3 + 2] = p[2];
+        }
+        ok = std::fwrite(row.data(), 1, row.size(), f) == row.size();
+    }
+    return std::fclose(f) == 0 && ok;
+}
+
+// ── PNG ─────────────────────────────────────────────────────────
+// Uncompressed: the zlib stream is a run of stored deflate blocks.  The
+// files are larger than a real encoder's, but need no zlib dependency.
+static std::uint32_t crc32_update(std::uint32_t crc, const std::uint8_t* data, std::size_t n) {
+    static const auto table = [] {
+        std::vector<std::uint32_t> t(256);
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (std::size_t i = 0; i < n; ++i) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void put_be32(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    out.push_back(std::uint8_t(v >> 24));
+    out.push_back(std::uint8_t(v >> 16));
+    out.push_back(std::uint8_t(v >> 8));
+    out.push_back(std::uint8_t(v));
+}
+
+static void put_chunk(std::vector<std::uint8_t>& out, const char* type,
+                      const std::vector<std::uint8_t>& data)
+{
+    put_be32(out, static_cast<std::uint32_t>(data.size()));
+    std::size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    put_be32(out, crc32_update(0, &out[start], out.size() - start));
+}
+
+bool write_png(const RgbaImage& img, const std::string& path) {
+    if (img.px.empty()) return false;
+
+    // Filter type 0 (none) in front of every scanline.
+    const std::size_t stride = std::size_t(img.w) * 4;
+    std::vector<std::uint8_t> raw;
+    raw.reserve((stride + 1) * img.h);
+    for (int y = 0; y < img.h; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), img.at(0, y), img.at(0, y) + stride);
+    }
+
+    std::vector<std::uint8_t> z = {0x78, 0x01};
+    std::uint32_t s1 = 1, s2 = 0;                    // Adler-32
+    for (std::uint8_t b : raw) { s1 = (s1 + b) % 65521; s2 = (s2 + s1) % 65521; }
+    for (std::size_t pos = 0;;) {
+        std::size_t len = std::min<std::size_t>(raw.size() - pos, 65535);
+        bool last = pos + len == raw.size();
+        z.push_back(last ? 1 : 0);
+        z.push_back(std::uint8_t(len));
+        z.push_back(std::uint8_t(len >> 8));
+        z.push_back(std::uint8_t(~len));
+        z.push_back(std::uint8_t(~len >> 8));
+        z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+        if (last) break;
+    }
+    put_be32(z, (s2 << 16) | s1);
+
+    std::vector<std::uint8_t> ihdr;
+    put_be32(ihdr, static_cast<std::uint32_t>(img.w));
+    put_be32(ihdr, static_cast<std::uint32_t>(img.h));
+    ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0});       // 8-bit RGBA, no interlace
+
+    std::vector<std::uint8_t> file = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    put_chunk(file, "IHDR", ihdr);
+    put_chunk(file, "IDAT", z);
+    put_chunk(file, "IEND", {});
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(file.data(), 1, file.size(), f) == file.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+bool write_image(const RgbaImage& img, const std::string& path) {
+    std::string ext = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+    for (char& c : ext) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return ext == ".png" ? write_png(img, path) : write_ppm(img, path);
+}
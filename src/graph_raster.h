@@ -0,0 +1,43 @@
+#pragma once
+
+#include "graph_params.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 8-bit RGBA framebuffer, rows top to bottom, 4 bytes per pixel.
+struct RgbaImage {
+    int w = 0;
+    int h = 0;
+    std::vector<std::uint8_t> px;
+
+    RgbaImage() = default;
+    RgbaImage(int w_, int h_) : w(w_), h(h_), px(std::size_t(w_) * h_ * 4, 0) {}
+
+    std::uint8_t* at(int x, int y) { return &px[(std::size_t(y) * w + x) * 4]; }
+    const std::uint8_t* at(int x, int y) const { return &px[(std::size_t(y) * w + x) * 4]; }
+};
+
+// Largest edge accepted by render_graph().  A full 4096 x 4096 RGBA image
+// is 64 MiB, and write_png() holds about three more copies (filtered rows,
+// zlib stream, file) while encoding.
+static constexpr int kMaxRenderSize = 4096;
+
+// Headless software rendering of the graph canvas: background, grid, axes
+// and an anti-aliased 2 px curve, laid out like GraphCanvas::draw() (same
+// CurveProjection, colours and decimated polyline).  The equation overlay
+// is not drawn — it needs FLTK fonts.  No display or FLTK is required, so
+// this is safe to call from any thread.  Returns an empty image if w or h
+// is outside [1, kMaxRenderSize], or if `cancelled` fired (it is polled
+// between stream chunks, see stream_curve()).
+RgbaImage render_graph(const GraphParams& p, int w, int h,
+                       const std::function<bool()>& cancelled = {});
+
+// Image writers.  Return false if the file could not be written.
+bool write_ppm(const RgbaImage& img, const std::string& path);   // binary P6, alpha dropped
+bool write_png(const RgbaImage& img, const std::string& path);   // RGBA, stored deflate
+
+// write_png() for paths ending in ".png" (any case), write_ppm() otherwise.
+bool write_image(const RgbaImage& img, const std::string& path);
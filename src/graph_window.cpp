@@ -1,7 +1,10 @@
 #include "graph_window.h"
+#include "plugin_process.h"
+#include "ui_thread.h"
 
 #include <FL/Fl.H>
 #include <FL/fl_draw.H>
+#include <FL/platform.H>
 
 #include <algorithm>
 #include <cmath>
@@ -13,61 +16,155 @@ static GraphWindow* g_graph = nullptr;
 void         set_graph_window(GraphWindow* gw) { g_graph = gw; }
 GraphWindow* get_graph_window()                { return g_graph; }
 
+// The handle's functions run on the UI thread.
+static GraphParams* handle_params() {
+    return g_graph ? &g_graph->params() : nullptr;
+}
+
+static void handle_changed(bool show) {
+    if (!g_graph) return;
+    if (show) g_graph->show();
+    g_graph->sync_and_redraw();
+}
+
+static FrameStats handle_frame_stats() {
+    return g_graph ? g_graph->frame_stats() : FrameStats{};
+}
+
+static void handle_launch_plugin(bool tk) {
+    if (tk) launch_tk_graph_plugin();
+    else    launch_tkinter_graph_plugin();
+}
+
+const GraphHandle& graph_window_handle() {
+    static const GraphHandle handle{handle_params, handle_changed,
+                                    handle_frame_stats, handle_launch_plugin};
+    return handle;
+}
+
 // ═════════════════════════════════════════════════════════════════
 //  GraphCanvas
 // ═════════════════════════════════════════════════════════════════
+// Uniform curves with more points than this are streamed on the worker
+// thread; the canvas keeps showing the previous geometry (or a progressive
+// preview) until the new one is ready.
+static constexpr int kAsyncPoints = 50000;
+
 GraphCanvas::GraphCanvas(int x, int y, int w, int h)
-    : Fl_Widget(x, y, w, h) {}
+    : Fl_Widget(x, y, w, h),
+      worker_([this, alive = std::weak_ptr<char>(alive_)] {
+          post_to_ui_thread([this, alive] { if (!alive.expired()) redraw(); });
+      }) {}
 
-void GraphCanvas::draw() {
-    // Background.
+// Stop the worker before anything it touches goes away, then invalidate
+// redraws it already posted.
+GraphCanvas::~GraphCanvas() {
+    worker_.stop();
+    alive_.reset();
+    if (grid_) fl_delete_offscreen(grid_);
+    if (layer_) fl_delete_offscreen(layer_);
+}
+
+void GraphCanvas::decimate(const CurveBuffer& cb, const CurveProjection& proj) {
+    if (cb.valid && cb.key == decim_key_ && w() == decim_w_ && h() == decim_h_)
+        return;
+    decim_key_ = cb.key;
+    decim_w_   = w();
+    decim_h_   = h();
+
+    decim_.reset();
+    for (std::size_t i = 0; i < cb.size(); ++i)
+        decim_.push(proj.sx(cb.xs[i]), proj.sy(cb.ys[i]));
+    decim_.finish();
+}
+
+// Screen-space polyline, offset by the widget origin.
+static void draw_polyline(const PolylineDecimator& line, int ox, int oy) {
+    fl_color(fl_rgb_color(0, 220, 120));
+    fl_line_style(FL_SOLID, 2);
+    fl_begin_line();
+    const auto& vx = line.xs();
+    const auto& vy = line.ys();
+    for (std::size_t i = 0; i < vx.size(); ++i)
+        fl_transformed_vertex(ox + vx[i], oy + vy[i]);
+    fl_end_line();
+    fl_line_style(0);
+}
+
+// Grid and axes, drawn at the offscreen origin.  Depends on size only.
+static void draw_grid(int w, int h) {
     fl_color(fl_rgb_color(12, 12, 22));
-    fl_rectf(x(), y(), w(), h());
+    fl_rectf(0, 0, w, h);
 
-    int cx   = x() + w() / 2;
-    int cy   = y() + h() / 2;
-    double scale = std::max(params.A, params.B) * 1.15;
-    if (scale < 0.01) scale = 1.0;
-    int half = std::min(w(), h()) / 2 - 10;
+    int cx   = w / 2;
+    int cy   = h / 2;
+    int half = std::min(w, h) / 2 - 10;
 
-    // Grid.
     fl_color(fl_rgb_color(30, 30, 45));
     for (int i = -4; i <= 4; ++i) {
         int gx = cx + i * half / 4;
         int gy = cy + i * half / 4;
-        fl_line(gx, y(), gx, y() + h());
-        fl_line(x(), gy, x() + w(), gy);
+        fl_line(gx, 0, gx, h);
+        fl_line(0, gy, w, gy);
     }
 
-    // Axes.
     fl_color(fl_rgb_color(70, 70, 90));
-    fl_line(x(), cy, x() + w(), cy);
-    fl_line(cx, y(), cx, y() + h());
+    fl_line(0, cy, w, cy);
+    fl_line(cx, 0, cx, h);
+}
 
-    // Curve.
-    fl_color(fl_rgb_color(0, 220, 120));
-    fl_line_style(FL_SOLID, 2);
-    fl_begin_line();
-    for (int i = 0; i <= params.num_points; ++i) {
-        double t = 2.0 * M_PI * i / params.num_points;
-        auto [px, py] = params.eval(t);
-        double wx = cx + (px / scale) * half;
-        double wy = cy - (py / scale) * half;
-        fl_vertex(wx, wy);
+void GraphCanvas::update_layers() {
+    bool resized = !grid_ || layer_w_ != w() || layer_h_ != h();
+    if (resized) {
+        if (grid_) fl_delete_offscreen(grid_);
+        if (layer_) fl_delete_offscreen(layer_);
+        layer_w_ = w();
+        layer_h_ = h();
+        grid_  = fl_create_offscreen(layer_w_, layer_h_);
+        layer_ = fl_create_offscreen(layer_w_, layer_h_);
+        fl_begin_offscreen(grid_);
+        draw_grid(layer_w_, layer_h_);
+        fl_end_offscreen();
     }
-    fl_end_line();
-    fl_line_style(0);
 
-    // Equation overlay.
+    const double eq[5] = {params.A, params.a, params.delta, params.B, params.b};
+    if (!resized && eq_valid_ && std::equal(eq, eq + 5, eq_key_)) return;
+    std::copy(eq, eq + 5, eq_key_);
+    eq_valid_ = true;
+
+    // Composite layer = grid + equation overlay.
+    fl_begin_offscreen(layer_);
+    fl_copy_offscreen(0, 0, layer_w_, layer_h_, grid_, 0, 0);
     fl_color(fl_rgb_color(170, 170, 190));
     fl_font(FL_COURIER, 12);
     char buf[128];
     std::snprintf(buf, sizeof(buf),
                   "x(t) = %.2f sin(%.2f t + %.2f)", params.A, params.a, params.delta);
-    fl_draw(buf, x() + 8, y() + 16);
+    fl_draw(buf, 8, 16);
     std::snprintf(buf, sizeof(buf),
                   "y(t) = %.2f sin(%.2f t)", params.B, params.b);
-    fl_draw(buf, x() + 8, y() + 32);
+    fl_draw(buf, 8, 32);
+    fl_end_offscreen();
+}
+
+void GraphCanvas::draw() {
+    // Background: cached grid, axes and equation overlay.
+    update_layers();
+    fl_copy_offscreen(x(), y(), w(), h(), layer_, 0, 0);
+
+    CurveProjection proj = CurveProjection::fit(params, w(), h());
+
+    // Dense uniform curves are streamed through the worker, which hands
+    // back an already decimated polyline; everything else is evaluated
+    // here (cached) and decimated to the canvas size.
+    if (params.num_points > kAsyncPoints && params.sampling == Sampling::uniform) {
+        worker_.request(params, w(), h());
+        worker_.with_front([&](const ScreenCurve& sc) { draw_polyline(sc.line, x(), y()); });
+        return;
+    }
+    curve_.update(params, proj.k);
+    decimate(curve_, proj);
+    draw_polyline(decim_, x(), y());
 }
 
 // ═════════════════════════════════════════════════════════════════
@@ -77,9 +174,29 @@ static constexpr int kSliderH   = 25;
 static constexpr int kSliderGap = 5;
 static constexpr int kLabelW    = 60;
 static constexpr int kPad       = 10;
-static constexpr int kNumSliders = 6;
+static constexpr int kNumSliders = static_cast<int>(kParamCount);   // one per kParamDescs row
 static constexpr int kSliderArea = kNumSliders * (kSliderH + kSliderGap);
 
+// Slider for one kParamDescs row.  A log row's value() is log10 of the
+// parameter, so the readout shows the parameter itself, kept short
+// enough for the value box ("2.5M", "250k").
+class ParamSlider : public Fl_Value_Slider {
+public:
+    ParamSlider(int x, int y, int w, int h, const ParamDesc& desc)
+        : Fl_Value_Slider(x, y, w, h, desc.name), desc_(desc) {}
+
+    int format(char* buf) override {
+        if (!desc_.log) return Fl_Value_Slider::format(buf);
+        double v = slider_value(desc_, value());
+        if (v >= 1e6) return std::snprintf(buf, 128, "%.3gM", v / 1e6);
+        if (v >= 1e4) return std::snprintf(buf, 128, "%.3gk", v / 1e3);
+        return std::snprintf(buf, 128, "%.0f", v);
+    }
+
+private:
+    const ParamDesc& desc_;
+};
+
 GraphWindow::GraphWindow(int w, int h, const char* title)
     : Fl_Double_Window(w, h, title)
 {
@@ -91,58 +208,66 @@ GraphWindow::GraphWindow(int w, int h, const char* title)
     int sy = kPad + canvas_h + kSliderGap;
     int sw = w - 2 * kPad - kLabelW;
 
-    auto make_slider = [&](const char* label, double lo, double hi,
-                           double val, double step) -> Fl_Value_Slider* {
-        auto* sl = new Fl_Value_Slider(kPad + kLabelW, sy, sw, kSliderH, label);
+    const GraphParams& p = canvas_->params;
+    for (std::size_t i = 0; i < kParamCount; ++i) {
+        const ParamDesc& d = kParamDescs[i];
+        auto* sl = new ParamSlider(kPad + kLabelW, sy, sw, kSliderH, d);
         sl->type(FL_HORIZONTAL);
-        sl->bounds(lo, hi);
-        sl->step(step);
-        sl->value(val);
+        sl->bounds(slider_pos(d, d.lo), slider_pos(d, d.hi));
+        sl->step(d.step);
+        sl->value(slider_pos(d, p.get(d.id)));
         sl->align(FL_ALIGN_LEFT);
         sl->callback(slider_cb, this);
+        sliders_[i] = sl;
         sy += kSliderH + kSliderGap;
-        return sl;
-    };
-
-    sl_a_     = make_slider("a",      1.0,  10.0,     3.0,          1.0);
-    sl_b_     = make_slider("b",      1.0,  10.0,     2.0,          1.0);
-    sl_delta_ = make_slider("delta",  0.0,  2*M_PI,   M_PI/2.0,     0.01);
-    sl_A_     = make_slider("A",      0.1,  2.0,      1.0,          0.05);
-    sl_B_     = make_slider("B",      0.1,  2.0,      1.0,          0.05);
-    sl_pts_   = make_slider("points", 100,  5000,     1000,         100);
+    }
 
     end();
     resizable(canvas_);
     size_range(400, 400);
 }
 
-void GraphWindow::slider_cb(Fl_Widget*, void* data) {
+GraphWindow::~GraphWindow() {
+    Fl::remove_timeout(frame_cb, this);
+}
+
+void GraphWindow::slider_cb(Fl_Widget* w, void* data) {
     auto* self = static_cast<GraphWindow*>(data);
-    self->sliders_to_params();
-    self->canvas_->redraw();
+    self->slider_to_param(w);
+    self->schedule_frame(false);
+}
+
+void GraphWindow::schedule_frame(bool sync_sliders) {
+    sync_pending_ = sync_pending_ || sync_sliders;
+    double delay = frames_.request(frame_clock_now());
+    if (delay >= 0.0) Fl::add_timeout(delay, frame_cb, this);
+}
+
+void GraphWindow::frame_cb(void* data) {
+    auto* self = static_cast<GraphWindow*>(data);
+    if (self->sync_pending_) {
+        self->params_to_sliders();
+        self->sync_pending_ = false;
+    }
+    if (self->frames_.flush(frame_clock_now(), self->params().fingerprint()))
+        self->canvas_->redraw();
 }
 
-void GraphWindow::sliders_to_params() {
-    auto& p = canvas_->params;
-    p.a          = sl_a_->value();
-    p.b          = sl_b_->value();
-    p.delta      = sl_delta_->value();
-    p.A          = sl_A_->value();
-    p.B          = sl_B_->value();
-    p.num_points = static_cast<int>(sl_pts_->value());
+// Only the moved slider is read back: the others may show a clamped view
+// of a console-set value (e.g. points beyond the slider's range).
+void GraphWindow::slider_to_param(Fl_Widget* w) {
+    for (std::size_t i = 0; i < kParamCount; ++i)
+        if (sliders_[i] == w)
+            canvas_->params.set(kParamDescs[i].id,
+                                slider_value(kParamDescs[i], sliders_[i]->value()));
 }
 
 void GraphWindow::params_to_sliders() {
     const auto& p = canvas_->params;
-    sl_a_->value(p.a);
-    sl_b_->value(p.b);
-    sl_delta_->value(p.delta);
-    sl_A_->value(p.A);
-    sl_B_->value(p.B);
-    sl_pts_->value(p.num_points);
+    for (std::size_t i = 0; i < kParamCount; ++i)
+        sliders_[i]->value(slider_pos(kParamDescs[i], p.get(kParamDescs[i].id)));
 }
 
 void GraphWindow::sync_and_redraw() {
-    params_to_sliders();
-    canvas_->redraw();
+    schedule_frame(true);
 }
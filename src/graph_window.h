@@ -1,44 +1,95 @@
 #pragma once
 
+#include "curve_buffer.h"
+#include "curve_projection.h"
+#include "curve_worker.h"
+#include "frame_scheduler.h"
+#include "graph_handle.h"
 #include "graph_params.h"
+#include "polyline_decimator.h"
 
 #include <FL/Fl_Double_Window.H>
 #include <FL/Fl_Widget.H>
 #include <FL/Fl_Value_Slider.H>
+#include <FL/platform_types.h>
+
+#include <memory>
 
 // Custom widget that draws the parametric curve.
 class GraphCanvas : public Fl_Widget {
 public:
     GraphCanvas(int x, int y, int w, int h);
+    ~GraphCanvas() override;
     void draw() override;
     GraphParams params;
+
+private:
+    // Refresh the offscreen background layers if the size or the
+    // equation parameters changed since they were last rendered.
+    void update_layers();
+
+    // Project `cb` to the widget and simplify it into decim_, unless the
+    // cached result already matches this geometry and size.
+    void decimate(const CurveBuffer& cb, const CurveProjection& proj);
+
+    CurveBuffer curve_;    // model-space samples, rebuilt on param change
+
+    // Redraws posted by the worker hold a weak reference to this; the
+    // destructor drops it, so one still queued finds the canvas gone.
+    std::shared_ptr<char> alive_ = std::make_shared<char>();
+    CurveWorker worker_;   // streams curves above kAsyncPoints off-thread
+
+    // Screen-space polyline actually sent to FLTK, relative to the widget
+    // origin and keyed on the curve key plus widget size.
+    PolylineDecimator decim_;
+    std::uint64_t     decim_key_ = 0;
+    int               decim_w_   = -1;
+    int               decim_h_   = -1;
+
+    Fl_Offscreen grid_    = 0;   // grid + axes, keyed on widget size
+    Fl_Offscreen layer_   = 0;   // grid_ + equation overlay
+    int          layer_w_ = 0;
+    int          layer_h_ = 0;
+    double       eq_key_[5] = {};   // A, a, delta, B, b last rendered
+    bool         eq_valid_  = false;
 };
 
 // Popup window: canvas + parameter sliders.
 class GraphWindow : public Fl_Double_Window {
 public:
     GraphWindow(int w, int h, const char* title);
+    ~GraphWindow() override;
 
     GraphParams&       params()       { return canvas_->params; }
     const GraphParams& params() const { return canvas_->params; }
 
-    // Push current params into sliders and redraw the canvas.
+    // Push current params into sliders and redraw the canvas.  Coalesced:
+    // any number of calls within one frame interval cause a single slider
+    // sync and a single redraw.
     void sync_and_redraw();
 
+    // Frame-coalescing counters (requests, merged, frames, dropped).
+    const FrameStats& frame_stats() const { return frames_.stats(); }
+
+    static constexpr double kTargetFps = 60.0;
+
 private:
     static void slider_cb(Fl_Widget* w, void* data);
-    void sliders_to_params();
+    static void frame_cb(void* data);
+    void schedule_frame(bool sync_sliders);
+    void slider_to_param(Fl_Widget* w);
     void params_to_sliders();
 
+    FrameScheduler    frames_{kTargetFps};
+    bool              sync_pending_ = false;
+
     GraphCanvas*      canvas_;
-    Fl_Value_Slider*  sl_a_;
-    Fl_Value_Slider*  sl_b_;
-    Fl_Value_Slider*  sl_delta_;
-    Fl_Value_Slider*  sl_A_;
-    Fl_Value_Slider*  sl_B_;
-    Fl_Value_Slider*  sl_pts_;
+    Fl_Value_Slider*  sliders_[kParamCount];   // indexed like kParamDescs
 };
 
 // Global singleton (set by main, used by console commands).
 void         set_graph_window(GraphWindow* gw);
 GraphWindow* get_graph_window();
+
+// GraphHandle on the singleton, for the console bindings.
+const GraphHandle& graph_window_handle();
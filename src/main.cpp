@@ -6,6 +6,7 @@
 #include "python_console.h"
 #include "graph_window.h"
 #include "plugin_process.h"
+#include "ui_thread.h"
 
 static TclConsole    g_tcl;
 static PythonConsole g_python;
@@ -17,6 +18,9 @@ static void tk_plugin_cb(Fl_Widget*, void*)   { launch_tk_graph_plugin(); }
 static void tkinter_plugin_cb(Fl_Widget*, void*) { launch_tkinter_graph_plugin(); }
 
 int main(int argc, char* argv[]) {
+    Fl::lock();   // enable Fl::awake() from the curve and interpreter threads
+    ui_thread_init(Fl::awake);
+
     Fl_Window win(420, 160, "FLTK Console Launcher");
     win.begin();
 
@@ -40,8 +44,9 @@ int main(int argc, char* argv[]) {
 
     int ret = Fl::run();
 
+    ui_thread_shutdown();
+    g_tcl.shutdown();
+    g_python.shutdown();
     set_graph_window(nullptr);
-    g_python.release_python_objects();
-    PythonConsole::finalize_python();
     return ret;
 }
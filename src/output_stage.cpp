@@ -0,0 +1,22 @@
+#include "output_stage.h"
+
+#include <algorithm>
+
+bool OutputStage::stage(const char* text, std::size_t len) {
+    if (len == 0) return false;
+    bool first = staged_.empty();
+    staged_.append(text, len);
+    return first;
+}
+
+// The committed buffer is (buffer + staged) minus the first `drop` bytes.
+// When the trim reaches past the old contents, the start of the staged
+// text is skipped rather than inserted and removed again.
+void OutputStage::commit(std::size_t have, const Edit& edit) {
+    if (staged_.empty()) return;
+    std::size_t drop   = scrollback_.append(staged_.data(), staged_.size());
+    std::size_t remove = std::min(drop, have);
+    edit(remove, staged_.c_str() + (drop - remove));
+    if (staged_.capacity() > kMaxIdleCapacity) std::string().swap(staged_);
+    else                                       staged_.clear();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "scrollback.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// Output queued for a console display and committed in batches.  Pure
+// bookkeeping like Scrollback, which it drives: the owner stages text as
+// it arrives and calls commit() once per frame with an edit callback for
+// its real buffer.  A burst of output thus costs one buffer append and at
+// most one front trim; lines that a trim would drop straight away are
+// never inserted.
+class OutputStage {
+public:
+    // Staging capacity kept between commits; a larger burst's is released.
+    static constexpr std::size_t kMaxIdleCapacity = 1 << 20;
+
+    // edit(remove, text): remove `remove` bytes from the front of the
+    // buffer, then append the NUL-terminated `text`.
+    using Edit = std::function<void(std::size_t remove, const char* text)>;
+
+    explicit OutputStage(std::size_t limit = Scrollback::kDefaultLimit)
+        : scrollback_(limit) {}
+
+    // Queue text.  Returns true if nothing was queued before, i.e. the
+    // owner should schedule a commit.
+    bool stage(const char* text, std::size_t len);
+
+    bool pending() const { return !staged_.empty(); }
+
+    // Move the queued text into a buffer currently holding `have` bytes.
+    // Calls edit at most once; does nothing if nothing is queued.
+    void commit(std::size_t have, const Edit& edit);
+
+    // Change the scrollback limit (0 = unlimited).  Commit first; returns
+    // the bytes to remove from the front of the buffer now.
+    std::size_t set_limit(std::size_t lines) { return scrollback_.set_limit(lines); }
+
+    ScrollbackStats stats() const { return scrollback_.stats(); }
+
+private:
+    Scrollback  scrollback_;
+    std::string staged_;
+};
@@ -0,0 +1,221 @@
+#include "param_sweep.h"
+#include "curve_stream.h"
+#include "work_pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ── SweepSpec ───────────────────────────────────────────────────
+SweepSpec SweepSpec::around(const GraphParams& p) {
+    SweepSpec s;
+    s.base  = p;
+    s.a     = {p.a, p.a, 1};
+    s.b     = {p.b, p.b, 1};
+    s.A     = {p.A, p.A, 1};
+    s.B     = {p.B, p.B, 1};
+    s.delta = {p.delta, p.delta, 1};
+    return s;
+}
+
+std::size_t SweepSpec::combinations() const {
+    std::size_t n = 1;
+    for (const SweepRange* r : {&a, &b, &A, &B, &delta}) {
+        if (r->steps < 1) return 0;
+        n *= static_cast<std::size_t>(r->steps);
+        if (n > kMaxCombinations) return n;
+    }
+    return n;
+}
+
+GraphParams SweepSpec::at(std::size_t i) const {
+    GraphParams p = base;
+    p.delta = delta.value(static_cast<int>(i % delta.steps)); i /= delta.steps;
+    p.B     = B.value(static_cast<int>(i % B.steps));         i /= B.steps;
+    p.A     = A.value(static_cast<int>(i % A.steps));         i /= A.steps;
+    p.b     = b.value(static_cast<int>(i % b.steps));         i /= b.steps;
+    p.a     = a.value(static_cast<int>(i));
+    return p;
+}
+
+bool parse_reducer(const std::string& name, SweepReducer& out) {
+    if      (name == "bbox")              out = SweepReducer::bbox;
+    else if (name == "arclength")         out = SweepReducer::arclength;
+    else if (name == "selfintersections") out = SweepReducer::selfintersections;
+    else return false;
+    return true;
+}
+
+const char* reducer_name(SweepReducer r) {
+    switch (r) {
+    case SweepReducer::bbox:              return "bbox";
+    case SweepReducer::arclength:         return "arclength";
+    case SweepReducer::selfintersections: return "selfintersections";
+    }
+    return "bbox";
+}
+
+// ── Self-intersections ──────────────────────────────────────────
+static double orient(double ax, double ay, double bx, double by, double cx, double cy) {
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+// Segments i and j cross at a single interior point; writes the point.
+static bool crossing(const std::vector<double>& xs, const std::vector<double>& ys,
+                     std::size_t i, std::size_t j, double& px, double& py)
+{
+    double ax = xs[i], ay = ys[i], bx = xs[i + 1], by = ys[i + 1];
+    double cx = xs[j], cy = ys[j], dx = xs[j + 1], dy = ys[j + 1];
+    double d1 = orient(ax, ay, bx, by, cx, cy);
+    double d2 = orient(ax, ay, bx, by, dx, dy);
+    double d3 = orient(cx, cy, dx, dy, ax, ay);
+    double d4 = orient(cx, cy, dx, dy, bx, by);
+    if (!(((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) &&
+          ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))))
+        return false;
+    double u = d3 / (d3 - d4);
+    px = ax + u * (bx - ax);
+    py = ay + u * (by - ay);
+    return true;
+}
+
+long count_self_intersections(const std::vector<double>& xs,
+                              const std::vector<double>& ys)
+{
+    const std::size_t n = xs.size();
+    if (n < 4) return 0;
+    const std::size_t segs = n - 1;
+    bool closed = std::hypot(xs[0] - xs[n - 1], ys[0] - ys[n - 1]) < 1e-9;
+
+    double xmin = *std::min_element(xs.begin(), xs.end());
+    double xmax = *std::max_element(xs.begin(), xs.end());
+    double ymin = *std::min_element(ys.begin(), ys.end());
+    double ymax = *std::max_element(ys.begin(), ys.end());
+
+    // ~1 segment per cell on average.
+    const int g = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(segs))));
+    double cw = std::max(xmax - xmin, 1e-12) / g;
+    double ch = std::max(ymax - ymin, 1e-12) / g;
+    auto cell_x = [&](double x) { return std::min(g - 1, static_cast<int>((x - xmin) / cw)); };
+    auto cell_y = [&](double y) { return std::min(g - 1, static_cast<int>((y - ymin) / ch)); };
+
+    std::vector<std::vector<std::size_t>> cells(static_cast<std::size_t>(g) * g);
+    for (std::size_t s = 0; s < segs; ++s) {
+        int x0 = cell_x(std::min(xs[s], xs[s + 1])), x1 = cell_x(std::max(xs[s], xs[s + 1]));
+        int y0 = cell_y(std::min(ys[s], ys[s + 1])), y1 = cell_y(std::max(ys[s], ys[s + 1]));
+        for (int cy = y0; cy <= y1; ++cy)
+            for (int cx = x0; cx <= x1; ++cx)
+                cells[static_cast<std::size_t>(cy) * g + cx].push_back(s);
+    }
+
+    // A pair sharing several cells is counted only in the cell that
+    // contains its crossing point.
+    long count = 0;
+    for (std::size_t c = 0; c < cells.size(); ++c) {
+        const auto& in = cells[c];
+        for (std::size_t p = 0; p < in.size(); ++p) {
+            for (std::size_t q = p + 1; q < in.size(); ++q) {
+                std::size_t i = in[p], j = in[q];
+                if (j == i + 1) continue;
+                if (closed && i == 0 && j == segs - 1) continue;
+                double px, py;
+                if (!crossing(xs, ys, i, j, px, py)) continue;
+                if (static_cast<std::size_t>(cell_y(py)) * g + cell_x(px) == c) ++count;
+            }
+        }
+    }
+    return count;
+}
+
+// Evaluate `count` samples of p over [t0, t1] into xs/ys kStreamChunk at a
+// time, so a long combination can stop between chunks.  False if `halted`
+// fired.
+static bool eval_chunked(const GraphParams& p, double t0, double t1, std::size_t count,
+                         double* xs, double* ys, const std::function<bool()>& halted)
+{
+    double dt = count > 1 ? (t1 - t0) / static_cast<double>(count - 1) : 0.0;
+    for (std::size_t start = 0; start < count; start += kStreamChunk) {
+        if (halted && halted()) return false;
+        std::size_t len = std::min(kStreamChunk, count - start);
+        p.eval_range(t0 + dt * static_cast<double>(start),
+                     t0 + dt * static_cast<double>(start + len - 1),
+                     len, xs + start, ys + start);
+    }
+    return true;
+}
+
+long self_intersections(const GraphParams& p,
+                        std::vector<double>& xs, std::vector<double>& ys,
+                        const std::function<bool()>& halted)
+{
+    // One closed period: retraced periods would overlap rather than cross.
+    // The grid is shifted off t = 0 by an irrational fraction of a step so
+    // symmetric crossings (t = 0, π, ...) never land exactly on a vertex.
+    SamplePlan plan = p.sample_plan(false);
+    double shift = plan.count > 1
+                 ? 0.3819660112501051 * (plan.t1 - plan.t0) / (plan.count - 1) : 0.0;
+    xs.resize(plan.count);
+    ys.resize(plan.count);
+    if (!eval_chunked(p, plan.t0 + shift, plan.t1 + shift, plan.count,
+                      xs.data(), ys.data(), halted))
+        return -1;
+    return count_self_intersections(xs, ys);
+}
+
+// ── run_sweep ───────────────────────────────────────────────────
+struct SweepScratch {
+    std::vector<double> xs, ys;
+};
+
+// False if `halted` fired before the samples were all evaluated.
+static bool reduce(const GraphParams& p, SweepReducer r, SweepScratch& scratch,
+                   SweepResult& out, const std::function<bool()>& halted)
+{
+    if (r == SweepReducer::selfintersections) {
+        out.crossings = self_intersections(p, scratch.xs, scratch.ys, halted);
+        return out.crossings >= 0;
+    }
+
+    SamplePlan plan = p.sample_plan();
+    scratch.xs.resize(plan.count);
+    scratch.ys.resize(plan.count);
+    if (!eval_chunked(p, plan.t0, plan.t1, plan.count,
+                      scratch.xs.data(), scratch.ys.data(), halted))
+        return false;
+    const auto& xs = scratch.xs;
+    const auto& ys = scratch.ys;
+
+    if (r == SweepReducer::bbox) {
+        auto [x0, x1] = std::minmax_element(xs.begin(), xs.end());
+        auto [y0, y1] = std::minmax_element(ys.begin(), ys.end());
+        out.xmin = *x0; out.xmax = *x1;
+        out.ymin = *y0; out.ymax = *y1;
+    } else {
+        double len = 0.0;
+        for (std::size_t i = 1; i < xs.size(); ++i)
+            len += std::hypot(xs[i] - xs[i - 1], ys[i] - ys[i - 1]);
+        out.length = len * plan.periods;
+    }
+    return true;
+}
+
+std::vector<SweepResult> run_sweep(const SweepSpec& spec,
+                                   const std::function<bool()>& cancelled)
+{
+    std::size_t n = spec.combinations();
+    if (n == 0 || n > SweepSpec::kMaxCombinations) return {};
+
+    std::vector<SweepResult> results(n);
+    unsigned threads = spec.threads ? spec.threads : default_thread_count();
+    threads = static_cast<unsigned>(std::min<std::size_t>(
+        {threads, std::size_t(default_thread_count()) * SweepSpec::kThreadsPerCore, n}));
+    std::vector<SweepScratch> scratch(threads);
+    bool done = parallel_for(n, threads, [&](std::size_t i, unsigned worker,
+                                             const std::function<bool()>& halted) {
+        GraphParams p = spec.at(i);
+        SweepResult& r = results[i];
+        r.a = p.a; r.b = p.b; r.A = p.A; r.B = p.B; r.delta = p.delta;
+        reduce(p, spec.reducer, scratch[worker], r, halted);
+    }, cancelled);
+    if (!done) results.clear();
+    return results;
+}
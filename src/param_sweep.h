@@ -0,0 +1,84 @@
+#pragma once
+
+#include "graph_params.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Per-combination summary computed by a sweep.
+enum class SweepReducer {
+    bbox,                // xmin, xmax, ymin, ymax of the samples
+    arclength,           // length of the sampled polyline over [0, 2π]
+    selfintersections,   // proper crossings of one closed period
+};
+
+// `steps` evenly spaced values on [lo, hi], both ends included; a single
+// step sweeps just `lo`.
+struct SweepRange {
+    double lo    = 0.0;
+    double hi    = 0.0;
+    int    steps = 1;
+
+    double value(int i) const {
+        return steps > 1 ? lo + (hi - lo) * i / (steps - 1) : lo;
+    }
+};
+
+// Cartesian product of ranges for a, b, A, B and delta.  `base` supplies
+// num_points and engine; its a/b/A/B/delta are ignored.
+struct SweepSpec {
+    GraphParams  base;
+    SweepRange   a, b, A, B, delta;
+    SweepReducer reducer = SweepReducer::bbox;
+    unsigned     threads = 0;                  // 0 = one per hardware thread
+
+    static constexpr std::size_t kMaxCombinations = 1000000;
+
+    // Largest `threads` the console bindings accept.  run_sweep() further
+    // caps the pool at kThreadsPerCore threads per hardware thread and at
+    // one per combination.
+    static constexpr unsigned kMaxThreads     = 256;
+    static constexpr unsigned kThreadsPerCore = 4;
+
+    // Seed every range with the single value currently in `p`.
+    static SweepSpec around(const GraphParams& p);
+
+    std::size_t combinations() const;
+
+    // Parameters of combination i; delta varies fastest, a slowest.
+    GraphParams at(std::size_t i) const;
+};
+
+struct SweepResult {
+    double a = 0, b = 0, A = 0, B = 0, delta = 0;
+    double xmin = 0, xmax = 0, ymin = 0, ymax = 0;   // bbox
+    double length   = 0;                             // arclength
+    long   crossings = 0;                            // selfintersections
+};
+
+// Evaluate every combination of `spec` on a work-stealing thread pool,
+// each on its own GraphParams copy.  Results are in combination order.
+// Touches no GUI state, so it is safe to call from any thread.  Polls
+// `cancelled` on the calling thread only (see parallel_for()), between
+// combinations and between kStreamChunk-sample chunks of one; returns an
+// empty vector if it fired.
+std::vector<SweepResult> run_sweep(const SweepSpec& spec,
+                                   const std::function<bool()>& cancelled = {});
+
+bool        parse_reducer(const std::string& name, SweepReducer& out);
+const char* reducer_name(SweepReducer r);
+
+// Proper crossings between non-adjacent segments of the polyline
+// (xs[i], ys[i]).  If the first and last vertices coincide the polyline is
+// treated as closed.  Uses a uniform grid so cost stays near-linear.
+long count_self_intersections(const std::vector<double>& xs,
+                              const std::vector<double>& ys);
+
+// Self-intersection count of one closed period of `p`, as the
+// selfintersections reducer computes it.  xs/ys are sample scratch.
+// Returns -1 if `halted` fired between sample chunks.
+long self_intersections(const GraphParams& p,
+                        std::vector<double>& xs, std::vector<double>& ys,
+                        const std::function<bool()>& halted = {});
@@ -0,0 +1,96 @@
+#include "polyline_decimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+static double cross(double ax, double ay, double bx, double by) {
+    return ax * by - ay * bx;
+}
+
+void PolylineDecimator::reset() {
+    xs_.clear();
+    ys_.clear();
+    pushed_   = 0;
+    has_prev_ = false;
+    cone_     = Cone::none;
+    max_dist_ = 0;
+}
+
+void PolylineDecimator::emit(double x, double y) {
+    xs_.push_back(x);
+    ys_.push_back(y);
+    ax_ = x;
+    ay_ = y;
+    cone_     = Cone::none;
+    max_dist_ = 0;
+}
+
+// Unit vectors of the directions from the anchor whose ray passes within
+// tol of a vertex at offset (dx, dy), distance d > tol: lower edge (lx, ly)
+// and upper edge (ux, uy), i.e. the offset direction rotated by ∓asin(tol/d).
+void PolylineDecimator::edges(double dx, double dy, double d,
+                              double& lx, double& ly, double& ux, double& uy) const {
+    double vx = dx / d, vy = dy / d;
+    double s  = tol_ / d;
+    double c  = std::sqrt(1.0 - s * s);
+    lx = vx * c + vy * s;   ly = vy * c - vx * s;
+    ux = vx * c - vy * s;   uy = vy * c + vx * s;
+}
+
+void PolylineDecimator::push(double x, double y) {
+    ++pushed_;
+    if (xs_.empty()) {
+        emit(x, y);
+        px_ = x; py_ = y; has_prev_ = true;
+        return;
+    }
+
+    double dx = x - ax_, dy = y - ay_;
+    double d  = std::sqrt(dx * dx + dy * dy);
+
+    // (x, y) may end the current segment only if its direction lies in the
+    // cone left by the vertices before it; it then narrows the cone.
+    bool keep = true;
+    if (d > tol_) {
+        if (cone_ == Cone::empty ||
+            (cone_ == Cone::open &&
+             (cross(lx_, ly_, dx, dy) < 0.0 || cross(dx, dy, ux_, uy_) < 0.0))) {
+            keep = false;
+        } else {
+            double lx, ly, ux, uy;
+            edges(dx, dy, d, lx, ly, ux, uy);
+            if (cone_ == Cone::none) {
+                lx_ = lx; ly_ = ly; ux_ = ux; uy_ = uy;
+                cone_ = Cone::open;
+            } else {
+                if (cross(lx_, ly_, lx, ly) > 0.0) { lx_ = lx; ly_ = ly; }
+                if (cross(ux, uy, ux_, uy_) > 0.0) { ux_ = ux; uy_ = uy; }
+                if (cross(lx_, ly_, ux_, uy_) < 0.0) cone_ = Cone::empty;
+            }
+        }
+    }
+    // Doubling back towards the anchor would leave earlier vertices past
+    // the end of the segment.
+    if (keep && d < max_dist_ - tol_) keep = false;
+
+    if (keep) {
+        max_dist_ = std::max(max_dist_, d);
+    } else {
+        emit(px_, py_);
+        // Re-seed the cone from the vertex that did not fit.
+        double ndx = x - ax_, ndy = y - ay_;
+        double nd  = std::sqrt(ndx * ndx + ndy * ndy);
+        max_dist_ = nd;
+        if (nd > tol_) {
+            edges(ndx, ndy, nd, lx_, ly_, ux_, uy_);
+            cone_ = Cone::open;
+        }
+    }
+    px_ = x; py_ = y; has_prev_ = true;
+}
+
+void PolylineDecimator::finish() {
+    if (!has_prev_) return;
+    if (pushed_ > 1) emit(px_, py_);
+    has_prev_ = false;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Streaming screen-space polyline simplification.
+//
+// Vertices are pushed in device coordinates.  From the last emitted vertex
+// the decimator keeps the cone of directions whose ray passes within `tol`
+// pixels of every vertex seen since; a vertex is emitted only when the next
+// one would empty the cone (or when the path doubles back).  Every input
+// vertex therefore lies within `tol` of the output, and the output size
+// depends on the curve's on-screen shape rather than on how densely it was
+// sampled.  Memory is O(output), so arbitrarily long inputs can be streamed.
+class PolylineDecimator {
+public:
+    explicit PolylineDecimator(double tol = 0.25) : tol_(tol) {}
+
+    // Drop all output and start a new polyline.
+    void reset();
+
+    void push(double x, double y);
+
+    // Emit the final vertex.  Call once after the last push().
+    void finish();
+
+    const std::vector<double>& xs() const { return xs_; }
+    const std::vector<double>& ys() const { return ys_; }
+    std::size_t size()   const { return xs_.size(); }
+    std::size_t pushed() const { return pushed_; }
+
+private:
+    enum class Cone { none, open, empty };
+
+    void emit(double x, double y);
+    void edges(double dx, double dy, double d,
+               double& lx, double& ly, double& ux, double& uy) const;
+
+    double tol_;
+    std::vector<double> xs_, ys_;
+    std::size_t pushed_ = 0;
+
+    double ax_ = 0, ay_ = 0;          // anchor (last emitted vertex)
+    double px_ = 0, py_ = 0;          // previous input vertex
+    bool   has_prev_ = false;
+    Cone   cone_     = Cone::none;
+    double lx_ = 0, ly_ = 0;          // cone edges as unit vectors:
+    double ux_ = 0, uy_ = 0;          // lower (clockwise) and upper
+    double max_dist_ = 0;             // farthest vertex from anchor so far
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Python.h>
+
+#include <climits>
+
+// Hand-rolled argument unpacking for METH_FASTCALL functions.  Each helper
+// sets a TypeError/ValueError in the style of PyArg_ParseTuple and returns
+// false on failure.  No tuple or format string is involved, so a call costs
+// only the type checks themselves.
+
+static inline bool py_nargs(const char* fn, Py_ssize_t nargs,
+                            Py_ssize_t min, Py_ssize_t max)
+{
+    if (nargs >= min && nargs <= max) return true;
+    if (min == max)
+        PyErr_Format(PyExc_TypeError, "%s() takes exactly %zd argument%s (%zd given)",
+                     fn, min, min == 1 ? "" : "s", nargs);
+    else
+        PyErr_Format(PyExc_TypeError, "%s() takes from %zd to %zd arguments (%zd given)",
+                     fn, min, max, nargs);
+    return false;
+}
+
+static inline bool py_arg_double(PyObject* o, double& out) {
+    if (PyFloat_CheckExact(o)) { out = PyFloat_AS_DOUBLE(o); return true; }
+    out = PyFloat_AsDouble(o);                    // ints and __float__/__index__
+    return !(out == -1.0 && PyErr_Occurred());
+}
+
+static inline bool py_arg_str(PyObject* o, const char*& out) {
+    if (!PyUnicode_Check(o)) {
+        PyErr_Format(PyExc_TypeError, "expected str, got %.200s", Py_TYPE(o)->tp_name);
+        return false;
+    }
+    out = PyUnicode_AsUTF8(o);
+    return out != nullptr;
+}
+
+static inline bool py_arg_ssize(PyObject* o, Py_ssize_t& out) {
+    out = PyNumber_AsSsize_t(o, PyExc_OverflowError);
+    return !(out == -1 && PyErr_Occurred());
+}
+
+static inline bool py_arg_int(PyObject* o, int& out) {
+    long v = PyLong_AsLong(o);
+    if (v == -1 && PyErr_Occurred()) return false;
+    if (v < INT_MIN || v > INT_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "value out of int range");
+        return false;
+    }
+    out = static_cast<int>(v);
+    return true;
+}
+
+// PyMethodDef slot for a function whose signature isn't PyCFunction
+// (METH_FASTCALL, METH_KEYWORDS).  The void(*)() hop silences
+// -Wcast-function-type.
+#define PY_CFUNC(fn) reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(fn))
@@ -0,0 +1,272 @@
+#include "py_executor.h"
+
+#include <Python.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+// Shared with the worker, which keeps it alive if shutdown() detaches it.
+struct PyExecutor::State {
+    Hooks                   hooks;
+    std::mutex              mu;
+    std::condition_variable cv;
+    std::deque<std::string> queue;         // guarded by mu
+    std::string             messages;      // executor notices, guarded by mu
+    PyObject*               out = nullptr; // writers, guarded by mu
+    PyObject*               err = nullptr;
+    unsigned long           py_thread = 0; // PyThread ident of the worker
+    unsigned long           command   = 0; // sequence number of the running command
+    bool                    consumed  = false; // a C call raised this command's interrupt
+    int                     senders   = 0; // interrupt threads still alive
+    bool                    quit      = false;
+    bool                    finished  = false;
+    std::atomic<bool>       busy{false};
+    std::atomic<bool>       interrupted{false};  // interrupt() hit the running command
+};
+
+thread_local PyExecutor::State* PyExecutor::current_ = nullptr;
+
+const std::atomic<bool>* PyExecutor::interrupt_flag() {
+    return current_ ? &current_->interrupted : nullptr;
+}
+
+void PyExecutor::consume_interrupt() {
+    if (!current_) return;
+    {
+        std::lock_guard<std::mutex> lk(current_->mu);
+        current_->consumed = true;
+    }
+    PyThreadState_SetAsyncExc(current_->py_thread, nullptr);
+}
+
+// Raise KeyboardInterrupt in command number `command` if it is still
+// running.  Runs on a throwaway thread: PyGILState_Ensure may wait for
+// the worker to drop the GIL and the caller (the UI) must not.  The
+// caller has already counted it in st->senders.
+void PyExecutor::send_interrupt(std::shared_ptr<State> st, unsigned long command) {
+    std::thread([st, command] {
+        PyGILState_STATE gil = PyGILState_Ensure();
+        {
+            std::lock_guard<std::mutex> lk(st->mu);
+            if (st->busy && st->command == command && !st->consumed)
+                PyThreadState_SetAsyncExc(st->py_thread, PyExc_KeyboardInterrupt);
+        }
+        PyGILState_Release(gil);
+        {
+            std::lock_guard<std::mutex> lk(st->mu);
+            --st->senders;
+        }
+        st->cv.notify_all();
+    }).detach();
+}
+
+PyExecutor::PyExecutor(Hooks hooks) : st_(std::make_shared<State>()) {
+    st_->hooks = std::move(hooks);
+}
+
+PyExecutor::~PyExecutor() { shutdown(); }
+
+bool PyExecutor::busy() const { return st_->busy; }
+
+void PyExecutor::start() {
+    if (thread_.joinable()) return;
+    thread_ = std::thread(run, st_);
+}
+
+void PyExecutor::submit(std::string line) {
+    {
+        std::lock_guard<std::mutex> lk(st_->mu);
+        st_->queue.push_back(std::move(line));
+    }
+    st_->cv.notify_all();
+}
+
+void PyExecutor::interrupt() {
+    unsigned long command;
+    {
+        std::lock_guard<std::mutex> lk(st_->mu);
+        st_->queue.clear();
+        if (!st_->busy) return;
+        st_->interrupted = true;
+        command = st_->command;
+        ++st_->senders;         // before unlocking, so the worker cannot finalize under it
+    }
+    send_interrupt(st_, command);
+}
+
+std::string PyExecutor::take_output() {
+    std::lock_guard<std::mutex> lk(st_->mu);
+    std::string text;
+    text.swap(st_->messages);
+    text += console_writer_take(st_->out);
+    text += console_writer_take(st_->err);
+    return text;
+}
+
+void PyExecutor::shutdown(std::chrono::milliseconds timeout) {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lk(st_->mu);
+        st_->quit = true;
+    }
+    st_->cv.notify_all();
+    interrupt();
+
+    std::unique_lock<std::mutex> lk(st_->mu);
+    bool stopped = st_->cv.wait_for(lk, timeout, [&] { return st_->finished; });
+    lk.unlock();
+    if (stopped) thread_.join();
+    else         thread_.detach();
+}
+
+// ── Worker thread ───────────────────────────────────────────────
+
+static void post_message(PyExecutor::Hooks& h, std::mutex& mu, std::string& messages,
+                         const std::string& text)
+{
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        messages += text;
+    }
+    if (h.output_ready) h.output_ready(h.ctx);
+}
+
+// Build the InteractiveConsole and install the writers.  On failure
+// returns nullptr with `error` describing the step that failed.
+static PyObject* new_console(PyExecutor::Hooks& h, PyObject* locals,
+                             PyObject*& out, PyObject*& err, const char*& error)
+{
+    PyObject* code_mod = PyImport_ImportModule("code");
+    if (!code_mod) { error = "could not import 'code'"; return nullptr; }
+    PyObject* ic_class = PyObject_GetAttrString(code_mod, "InteractiveConsole");
+    Py_DECREF(code_mod);
+    if (!ic_class) { error = "InteractiveConsole not found"; return nullptr; }
+    PyObject* console = PyObject_CallOneArg(ic_class, locals);
+    Py_DECREF(ic_class);
+    if (!console) { error = "could not create InteractiveConsole"; return nullptr; }
+
+    out = console_writer_new(h.output_ready, h.ctx);
+    err = console_writer_new(h.output_ready, h.ctx);
+    if (!out || !err) { error = "console writer failed"; Py_DECREF(console); return nullptr; }
+    PyObject* sys_mod = PyImport_ImportModule("sys");
+    if (sys_mod) {
+        PyObject_SetAttrString(sys_mod, "stdout", out);
+        PyObject_SetAttrString(sys_mod, "stderr", err);
+        Py_DECREF(sys_mod);
+    }
+
+    if (h.setup && !h.setup(locals)) { error = "console setup failed"; Py_DECREF(console); return nullptr; }
+    return console;
+}
+
+// One console line; returns InteractiveConsole.push()'s "more input" flag.
+static bool push_line(PyObject* console, const std::string& line, std::string& notice) {
+    bool more = false;
+    PyObject* r = PyObject_CallMethod(console, "push", "s", line.c_str());
+    if (r) {
+        more = PyObject_IsTrue(r) == 1;
+        Py_DECREF(r);
+    } else if (PyErr_ExceptionMatches(PyExc_SystemExit)) {
+        PyErr_Clear();          // exiting from a worker thread would tear down the app
+        notice = "exit() is disabled in the console; close the window instead\n";
+    } else {
+        PyErr_Print();
+    }
+    return more;
+}
+
+void PyExecutor::run(std::shared_ptr<State> st) {
+    Hooks& h = st->hooks;
+    if (h.before_init) h.before_init();
+    Py_Initialize();
+    st->py_thread = PyThread_get_thread_ident();
+    current_ = st.get();
+
+    PyObject* locals  = PyDict_New();
+    PyObject* out     = nullptr;
+    PyObject* err     = nullptr;
+    const char* error = nullptr;
+    PyObject* console = new_console(h, locals, out, err, error);
+    {
+        std::lock_guard<std::mutex> lk(st->mu);
+        st->out = out;
+        st->err = err;
+    }
+    if (console) {
+        post_message(h, st->mu, st->messages, std::string("Python ") + Py_GetVersion() + "\n");
+    } else {
+        post_message(h, st->mu, st->messages, std::string("ERROR: ") + error + "\n");
+        PyErr_Print();
+    }
+
+    PyThreadState* ts = PyEval_SaveThread();
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(st->mu);
+            st->cv.wait(lk, [&] { return st->quit || !st->queue.empty(); });
+            if (st->quit) break;
+        }
+        // Drop an interrupt aimed at the previous command that landed
+        // after it finished.  This must happen before the next command is
+        // published as running: an interrupt() for that one could
+        // otherwise be wiped here.
+        PyEval_RestoreThread(ts);
+        PyThreadState_SetAsyncExc(st->py_thread, nullptr);
+        std::string line;
+        bool have_line = false;
+        {
+            std::lock_guard<std::mutex> lk(st->mu);
+            if (!st->quit && !st->queue.empty()) {   // interrupt() may have emptied it
+                line = std::move(st->queue.front());
+                st->queue.pop_front();
+                ++st->command;
+                st->consumed    = false;
+                st->interrupted = false;
+                st->busy        = true;
+                have_line       = true;
+            }
+        }
+        if (!have_line) {
+            ts = PyEval_SaveThread();
+            continue;
+        }
+        std::string notice;
+        bool more = console ? push_line(console, line, notice) : false;
+        ts = PyEval_SaveThread();
+        st->busy = false;
+        {
+            // Seal this command's output so a later take_output() cannot
+            // reorder it behind the next command's stdout.
+            std::lock_guard<std::mutex> lk(st->mu);
+            st->messages += console_writer_take(out);
+            st->messages += console_writer_take(err);
+        }
+        if (!notice.empty()) post_message(h, st->mu, st->messages, notice);
+        if (h.done) h.done(more);
+    }
+    {
+        std::unique_lock<std::mutex> lk(st->mu);
+        st->cv.wait(lk, [&] { return st->senders == 0; });   // they need the GIL
+    }
+    PyEval_RestoreThread(ts);
+
+    {
+        std::lock_guard<std::mutex> lk(st->mu);
+        st->out = nullptr;
+        st->err = nullptr;
+    }
+    Py_XDECREF(console);
+    Py_XDECREF(out);
+    Py_XDECREF(err);
+    Py_XDECREF(locals);
+    Py_FinalizeEx();
+
+    {
+        std::lock_guard<std::mutex> lk(st->mu);
+        st->finished = true;
+    }
+    st->cv.notify_all();
+}
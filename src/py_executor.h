@@ -0,0 +1,83 @@
+#pragma once
+
+#include "py_writer.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+struct _object;
+typedef _object PyObject;
+
+// Runs the embedded Python interpreter on its own thread.
+//
+// The worker owns the interpreter from Py_Initialize to Py_FinalizeEx.
+// Console lines are queued by submit() and fed to
+// code.InteractiveConsole.push one at a time; between commands the worker
+// sleeps with the GIL released.  stdout/stderr are native writers
+// (py_writer.h) drained by take_output() from any thread.
+//
+// Hooks run on the worker thread and must only post to the UI (e.g.
+// Fl::awake), never block on it.
+class PyExecutor {
+public:
+    struct Hooks {
+        std::function<void()>                before_init;  // before Py_Initialize
+        std::function<bool(PyObject* locals)> setup;       // GIL held; false = Python error set
+        std::function<void(bool more)>       done;         // after each command
+        ConsoleWriterNotify                  output_ready = nullptr;
+        void*                                ctx          = nullptr;
+    };
+
+    explicit PyExecutor(Hooks hooks);
+    ~PyExecutor();
+
+    PyExecutor(const PyExecutor&)            = delete;
+    PyExecutor& operator=(const PyExecutor&) = delete;
+
+    // Start the worker (once); the banner or init errors arrive as output.
+    void start();
+
+    // Queue one console line.
+    void submit(std::string line);
+
+    // Raise KeyboardInterrupt in the running command (PyThreadState_
+    // SetAsyncExc) and drop queued ones.  Never blocks; code inside a
+    // long C call sees it when the call returns, unless the call polls
+    // interrupt_flag().
+    void interrupt();
+
+    // On an executor's worker thread: a flag interrupt() sets for the
+    // running command, which long C calls made with the GIL released may
+    // poll from any thread (e.g. as a run_sweep() cancel predicate).
+    // nullptr on other threads.
+    static const std::atomic<bool>* interrupt_flag();
+
+    // A C call stopped because interrupt_flag() was set and raises
+    // KeyboardInterrupt itself: drop the asynchronous one, so the command
+    // sees a single exception.  Call on the worker thread, GIL held.
+    static void consume_interrupt();
+
+    // Everything printed since the last call, in order.
+    std::string take_output();
+
+    // True while a command is executing.
+    bool busy() const;
+
+    // Interrupt, stop the worker and finalize Python.  A worker that does
+    // not stop within `timeout` is detached and Python is left running.
+    void shutdown(std::chrono::milliseconds timeout = std::chrono::seconds(2));
+
+private:
+    struct State;
+    static void run(std::shared_ptr<State> st);
+    static void send_interrupt(std::shared_ptr<State> st, unsigned long command);
+
+    static thread_local State* current_;   // the worker's own State
+
+    std::shared_ptr<State> st_;
+    std::thread            thread_;
+};
@@ -0,0 +1,114 @@
+#include "py_writer.h"
+
+#include <Python.h>
+
+#include <mutex>
+#include <utility>
+
+struct WriterBuffer {
+    std::mutex          mu;
+    std::string         text;
+    ConsoleWriterNotify notify = nullptr;
+    void*               ctx    = nullptr;
+};
+
+struct WriterObject {
+    PyObject_HEAD
+    WriterBuffer* buf;
+};
+
+static PyObject* g_writer_type = nullptr;
+
+// Py_AtExit hook: the type dies with the interpreter, so the next
+// Py_Initialize builds a fresh one.
+static void forget_writer_type() { g_writer_type = nullptr; }
+
+static void writer_dealloc(PyObject* self) {
+    PyTypeObject* tp = Py_TYPE(self);
+    delete reinterpret_cast<WriterObject*>(self)->buf;
+    tp->tp_free(self);
+    Py_DECREF(tp);
+}
+
+static PyObject* writer_write(PyObject* self, PyObject* arg) {
+    if (!PyUnicode_Check(arg)) {
+        PyErr_Format(PyExc_TypeError, "write() argument must be str, not %.200s",
+                     Py_TYPE(arg)->tp_name);
+        return nullptr;
+    }
+    Py_ssize_t len;
+    const char* s = PyUnicode_AsUTF8AndSize(arg, &len);
+    if (!s) return nullptr;
+
+    WriterBuffer* b = reinterpret_cast<WriterObject*>(self)->buf;
+    bool first;
+    {
+        std::lock_guard<std::mutex> lk(b->mu);
+        first = b->text.empty() && len > 0;
+        b->text.append(s, static_cast<std::size_t>(len));
+    }
+    if (first && b->notify) b->notify(b->ctx);
+    return PyLong_FromSsize_t(PyUnicode_GET_LENGTH(arg));
+}
+
+static PyObject* writer_flush(PyObject*, PyObject*)    { Py_RETURN_NONE; }
+static PyObject* writer_isatty(PyObject*, PyObject*)   { Py_RETURN_FALSE; }
+static PyObject* writer_writable(PyObject*, PyObject*) { Py_RETURN_TRUE; }
+
+static PyObject* writer_encoding(PyObject*, void*) { return PyUnicode_FromString("utf-8"); }
+static PyObject* writer_errors(PyObject*, void*)   { return PyUnicode_FromString("strict"); }
+
+static PyMethodDef writer_methods[] = {
+    {"write",    writer_write,    METH_O,      "write(s) -> number of characters"},
+    {"flush",    writer_flush,    METH_NOARGS, "No-op: output is drained by the console"},
+    {"isatty",   writer_isatty,   METH_NOARGS, "Always False"},
+    {"writable", writer_writable, METH_NOARGS, "Always True"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyGetSetDef writer_getset[] = {
+    {"encoding", writer_encoding, nullptr, nullptr, nullptr},
+    {"errors",   writer_errors,   nullptr, nullptr, nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+static PyType_Slot writer_slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(writer_dealloc)},
+    {Py_tp_methods, writer_methods},
+    {Py_tp_getset,  writer_getset},
+    {Py_tp_doc,     const_cast<char*>("Console output stream")},
+    {0, nullptr}
+};
+
+static PyType_Spec writer_spec = {
+    "fltkconsole.Writer",
+    sizeof(WriterObject),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION,
+    writer_slots,
+};
+
+PyObject* console_writer_new(ConsoleWriterNotify notify, void* ctx) {
+    if (!g_writer_type) {
+        g_writer_type = PyType_FromSpec(&writer_spec);
+        if (!g_writer_type) return nullptr;
+        Py_AtExit(forget_writer_type);
+    }
+    auto* tp   = reinterpret_cast<PyTypeObject*>(g_writer_type);
+    auto* self = reinterpret_cast<WriterObject*>(tp->tp_alloc(tp, 0));
+    if (!self) return nullptr;
+    self->buf = new WriterBuffer;
+    self->buf->notify = notify;
+    self->buf->ctx    = ctx;
+    return reinterpret_cast<PyObject*>(self);
+}
+
+std::string console_writer_take(PyObject* writer) {
+    if (!writer || Py_TYPE(writer) != reinterpret_cast<PyTypeObject*>(g_writer_type))
+        return {};
+    WriterBuffer* b = reinterpret_cast<WriterObject*>(writer)->buf;
+    std::string out;
+    std::lock_guard<std::mutex> lk(b->mu);
+    out.swap(b->text);
+    return out;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+struct _object;
+typedef _object PyObject;
+
+// Native text stream for sys.stdout / sys.stderr.
+//
+// write() appends the UTF-8 text straight into a C++ buffer; the owner
+// drains it with console_writer_take(), which makes no Python calls.  The
+// buffer is guarded by its own mutex, so take() may run without the GIL
+// and from any thread.  Supports write, flush, isatty, writable and the
+// encoding/errors attributes that print() and traceback need.
+//
+// The type is created on first use and forgotten at Py_FinalizeEx, so
+// the interpreter may be re-initialised (even on another thread).
+
+// Called with `ctx` when a write lands in an empty buffer, i.e. once per
+// batch of output until the next take().  Runs on the writing thread with
+// the GIL held; it should only post (e.g. Fl::awake).
+using ConsoleWriterNotify = void (*)(void* ctx);
+
+// New reference, or nullptr with a Python error set.
+PyObject* console_writer_new(ConsoleWriterNotify notify = nullptr, void* ctx = nullptr);
+
+// Return and clear everything written so far.  `writer` must be an object
+// from console_writer_new(); anything else yields "".
+std::string console_writer_take(PyObject* writer);
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "console_window.h"
+#include "py_executor.h"
 
-struct _object;
-typedef _object PyObject;
+#include <atomic>
 
+// Python console window.  The interpreter lives on a PyExecutor thread, so
+// long-running commands never block the FLTK loop; Ctrl+C in the input
+// field interrupts the running command.
 class PythonConsole {
 public:
     PythonConsole();
@@ -12,25 +15,21 @@ public:
 
     void show();
 
-    // Release all Python object refs. Safe to call multiple times.
-    // Must be called while the Python interpreter is still alive.
-    void release_python_objects();
-
-    static void finalize_python();
+    // Stop the interpreter thread and finalize Python.  Call on the UI
+    // thread after Fl::run() returns (and after ui_thread_shutdown(), so a
+    // command waiting on the UI fails instead of blocking).
+    void shutdown();
 
 private:
     void ensure_init();
-    void init_python();
     void on_command(const char* cmd);
+    void on_interrupt();
     void flush_output();
+    static void output_ready(void* data);
+    static void flush_cb(void* data);
+    static void command_done_cb(void* data);
 
-    ConsoleWindow* win_       = nullptr;
-
-    PyObject* console_obj_    = nullptr;
-    PyObject* capture_out_    = nullptr;
-    PyObject* capture_err_    = nullptr;
-    PyObject* locals_         = nullptr;
-
-    bool more_ = false;
-    static bool py_initialized_;
+    ConsoleWindow*    win_ = nullptr;
+    PyExecutor        exec_;
+    std::atomic<bool> more_{false};
 };
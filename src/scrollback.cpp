@@ -0,0 +1,53 @@
+#include "scrollback.h"
+
+#include <algorithm>
+#include <cstring>
+
+std::size_t Scrollback::append(const char* text, std::size_t len) {
+    bytes_ += len;
+    const char* end = text + len;
+    while (text < end) {
+        const char* nl = static_cast<const char*>(std::memchr(text, '\n', end - text));
+        std::size_t n  = (nl ? nl + 1 : end) - text;
+        if (open_) lines_.back() += n;
+        else       lines_.push_back(n);
+        open_ = !nl;
+        text += n;
+    }
+    if (limit_ == 0) return 0;
+    std::size_t chunk = std::max<std::size_t>(limit_ / 8, 1);
+    return lines_.size() > limit_ + chunk ? trim_to(limit_) : 0;
+}
+
+std::size_t Scrollback::set_limit(std::size_t lines) {
+    limit_ = lines;
+    return limit_ != 0 && lines_.size() > limit_ ? trim_to(limit_) : 0;
+}
+
+void Scrollback::clear() {
+    lines_.clear();
+    open_  = false;
+    bytes_ = 0;
+}
+
+std::size_t Scrollback::trim_to(std::size_t keep) {
+    std::size_t drop = 0;
+    while (lines_.size() > keep) {
+        drop += lines_.front();
+        lines_.pop_front();
+        ++trimmed_;
+    }
+    if (lines_.empty()) open_ = false;
+    bytes_ -= drop;
+    return drop;
+}
+
+ScrollbackStats Scrollback::stats() const {
+    ScrollbackStats st;
+    st.lines       = lines_.size();
+    st.bytes       = bytes_;
+    st.index_bytes = lines_.size() * sizeof(std::size_t);
+    st.limit       = limit_;
+    st.trimmed     = trimmed_;
+    return st;
+}
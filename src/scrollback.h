@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+// Counters reported by Scrollback.
+struct ScrollbackStats {
+    std::size_t   lines       = 0;   // lines held, including an unterminated last line
+    std::size_t   bytes       = 0;   // text bytes held
+    std::size_t   index_bytes = 0;   // approximate memory used by the line index
+    std::size_t   limit       = 0;   // lines kept after a trim; 0 = unlimited
+    unsigned long trimmed     = 0;   // lines dropped so far
+};
+
+// Line bookkeeping for a bounded text log.  Pure bookkeeping: the owner
+// appends the same text to its buffer and removes the byte count returned
+// from the front.  Trimming waits until the log is a chunk (limit/8 lines)
+// over the limit and then drops back to it, so the cost of shifting the
+// owner's buffer is shared by a chunk's worth of appends.
+class Scrollback {
+public:
+    static constexpr std::size_t kDefaultLimit = 10000;
+
+    explicit Scrollback(std::size_t limit = kDefaultLimit) : limit_(limit) {}
+
+    // Record `len` appended bytes.  Returns how many bytes to remove from
+    // the front of the buffer (0 until a trim is due).
+    std::size_t append(const char* text, std::size_t len);
+
+    // Change the limit (0 = unlimited).  Returns bytes to remove now.
+    std::size_t set_limit(std::size_t lines);
+
+    // The owner emptied its buffer.
+    void clear();
+
+    ScrollbackStats stats() const;
+
+private:
+    std::size_t trim_to(std::size_t keep);
+
+    std::deque<std::size_t> lines_;          // byte length of each line, '\n' included
+    bool                    open_    = false; // last line has no '\n' yet
+    std::size_t             bytes_   = 0;
+    std::size_t             limit_;
+    unsigned long           trimmed_ = 0;
+};
@@ -0,0 +1,222 @@
+#include "sine_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SINE_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+// All kernels use the same scheme:
+//   k = round(x / pi)                 (via the 1.5 * 2^52 magic-number trick)
+//   r = x - k*pi                      (three-part Cody–Waite, r in [-pi/2, pi/2])
+//   sin(x) = (-1)^k * sin(r)          (parity taken from the low mantissa bit)
+// and sin(r) is an odd Taylor polynomial through r^17.  The reduction
+// stops being exact past kMaxReduced, so larger and non-finite lanes are
+// patched with std::sin.
+
+static constexpr double kInvPi = 0x1.45f306dc9c883p-2;
+static constexpr double kMagic = 0x1.8p52;
+static constexpr double kPiA   = 0x1.921fb50000000p+1;   // 26-bit split of pi,
+static constexpr double kPiB   = 0x1.110b460000000p-25;  // so k*kPiA and k*kPiB
+static constexpr double kPiC   = 0x1.1a62633145c07p-53;  // are exact for k < 2^26
+static constexpr double kMaxReduced = 1e8;               // < 2^26 * pi
+
+static constexpr double kS3  = -1.0 / 6.0;
+static constexpr double kS5  =  1.0 / 120.0;
+static constexpr double kS7  = -1.0 / 5040.0;
+static constexpr double kS9  =  1.0 / 362880.0;
+static constexpr double kS11 = -1.0 / 39916800.0;
+static constexpr double kS13 =  1.0 / 6227020800.0;
+static constexpr double kS15 = -1.0 / 1307674368000.0;
+static constexpr double kS17 =  1.0 / 355687428096000.0;
+
+// ── Portable scalar kernel (also handles vector-loop tails) ─────
+static void sin_scalar(const double* in, double* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double x  = in[i];
+        if (!(std::fabs(x) <= kMaxReduced)) {   // also catches NaN
+            out[i] = std::sin(x);
+            continue;
+        }
+        double kd = x * kInvPi + kMagic;
+        std::uint64_t bits;
+        std::memcpy(&bits, &kd, sizeof(bits));
+        double k  = kd - kMagic;
+        double r  = ((x - k * kPiA) - k * kPiB) - k * kPiC;
+        double r2 = r * r;
+        double p  = kS17;
+        p = p * r2 + kS15;
+        p = p * r2 + kS13;
+        p = p * r2 + kS11;
+        p = p * r2 + kS9;
+        p = p * r2 + kS7;
+        p = p * r2 + kS5;
+        p = p * r2 + kS3;
+        double s = r + r * r2 * p;
+        out[i] = (bits & 1) ? -s : s;
+    }
+}
+
+#ifdef SINE_KERNEL_X86
+
+// ── SSE2 kernel (x86-64 baseline, 2 lanes) ──────────────────────
+static void sin_sse2(const double* in, double* out, std::size_t n) {
+    const __m128d inv_pi = _mm_set1_pd(kInvPi);
+    const __m128d magic  = _mm_set1_pd(kMagic);
+    const __m128d pa = _mm_set1_pd(kPiA), pb = _mm_set1_pd(kPiB), pc = _mm_set1_pd(kPiC);
+    const __m128d abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    const __m128d limit    = _mm_set1_pd(kMaxReduced);
+
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x  = _mm_loadu_pd(in + i);
+        __m128d kd = _mm_add_pd(_mm_mul_pd(x, inv_pi), magic);
+        __m128d k  = _mm_sub_pd(kd, magic);
+        __m128d r  = _mm_sub_pd(x, _mm_mul_pd(k, pa));
+        r = _mm_sub_pd(r, _mm_mul_pd(k, pb));
+        r = _mm_sub_pd(r, _mm_mul_pd(k, pc));
+        __m128d r2 = _mm_mul_pd(r, r);
+        __m128d p  = _mm_set1_pd(kS17);
+        p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(kS15));
+        p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(kS13));
+        p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(kS11));
+        p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(kS9));
+        p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(kS7));
+        p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(kS5));
+        p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(kS3));
+        __m128d s = _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, r2), p));
+        __m128i sign = _mm_slli_epi64(_mm_castpd_si128(kd), 63);
+        int big = _mm_movemask_pd(_mm_cmpnle_pd(_mm_and_pd(x, abs_mask), limit));
+        _mm_storeu_pd(out + i, _mm_xor_pd(s, _mm_castsi128_pd(sign)));
+        if (big) {
+            alignas(16) double xs[2];
+            _mm_store_pd(xs, x);
+            for (int j = 0; j < 2; ++j)
+                if (big & (1 << j)) out[i + j] = std::sin(xs[j]);
+        }
+    }
+    sin_scalar(in + i, out + i, n - i);
+}
+
+// ── AVX2 + FMA kernel (4 lanes) ─────────────────────────────────
+__attribute__((target("avx2,fma")))
+static void sin_avx2(const double* in, double* out, std::size_t n) {
+    const __m256d inv_pi = _mm256_set1_pd(kInvPi);
+    const __m256d magic  = _mm256_set1_pd(kMagic);
+    const __m256d pa = _mm256_set1_pd(kPiA), pb = _mm256_set1_pd(kPiB), pc = _mm256_set1_pd(kPiC);
+    const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    const __m256d limit    = _mm256_set1_pd(kMaxReduced);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x  = _mm256_loadu_pd(in + i);
+        __m256d kd = _mm256_fmadd_pd(x, inv_pi, magic);
+        __m256d k  = _mm256_sub_pd(kd, magic);
+        __m256d r  = _mm256_fnmadd_pd(k, pa, x);
+        r = _mm256_fnmadd_pd(k, pb, r);
+        r = _mm256_fnmadd_pd(k, pc, r);
+        __m256d r2 = _mm256_mul_pd(r, r);
+        __m256d p  = _mm256_set1_pd(kS17);
+        p = _mm256_fmadd_pd(p, r2, _mm256_set1_pd(kS15));
+        p = _mm256_fmadd_pd(p, r2, _mm256_set1_pd(kS13));
+        p = _mm256_fmadd_pd(p, r2, _mm256_set1_pd(kS11));
+        p = _mm256_fmadd_pd(p, r2, _mm256_set1_pd(kS9));
+        p = _mm256_fmadd_pd(p, r2, _mm256_set1_pd(kS7));
+        p = _mm256_fmadd_pd(p, r2, _mm256_set1_pd(kS5));
+        p = _mm256_fmadd_pd(p, r2, _mm256_set1_pd(kS3));
+        __m256d s = _mm256_fmadd_pd(_mm256_mul_pd(r, r2), p, r);
+        __m256i sign = _mm256_slli_epi64(_mm256_castpd_si256(kd), 63);
+        int big = _mm256_movemask_pd(
+            _mm256_cmp_pd(_mm256_and_pd(x, abs_mask), limit, _CMP_NLE_UQ));
+        _mm256_storeu_pd(out + i, _mm256_xor_pd(s, _mm256_castsi256_pd(sign)));
+        if (big) {
+            alignas(32) double xs[4];
+            _mm256_store_pd(xs, x);
+            for (int j = 0; j < 4; ++j)
+                if (big & (1 << j)) out[i + j] = std::sin(xs[j]);
+        }
+    }
+    sin_scalar(in + i, out + i, n - i);
+}
+
+#endif // SINE_KERNEL_X86
+
+// ── Runtime dispatch ────────────────────────────────────────────
+using SinKernelFn = void (*)(const double*, double*, std::size_t);
+
+struct SinKernel {
+    SinKernelFn fn;
+    const char* name;
+};
+
+static SinKernel choose_kernel() {
+#ifdef SINE_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return {sin_avx2, "avx2"};
+    return {sin_sse2, "sse2"};
+#else
+    return {sin_scalar, "scalar"};
+#endif
+}
+
+static const SinKernel& kernel() {
+    static const SinKernel k = choose_kernel();
+    return k;
+}
+
+void sin_batch(const double* in, double* out, std::size_t n) {
+    kernel().fn(in, out, n);
+}
+
+const char* sin_batch_isa() {
+    return kernel().name;
+}
+
+// ── Rotation recurrence ─────────────────────────────────────────
+// Blocks of kSinSequenceReseed samples are independent once seeded, so
+// kLanes of them advance in lock-step: the lanes break the serial
+// dependency of the recurrence and let the compiler vectorize across them.
+static constexpr std::size_t kLanes = 4;
+
+void sin_sequence(double phase0, double step, std::size_t n, double* out) {
+    const double cs = std::cos(step);
+    const double sn = std::sin(step);
+    const std::size_t block = kSinSequenceReseed;
+    const std::size_t group = block * kLanes;
+
+    std::size_t base = 0;
+    for (; base + group <= n; base += group) {
+        double s[kLanes], c[kLanes];
+        for (std::size_t k = 0; k < kLanes; ++k) {
+            double phase = phase0 + step * static_cast<double>(base + k * block);
+            s[k] = std::sin(phase);
+            c[k] = std::cos(phase);
+        }
+        for (std::size_t j = 0; j < block; ++j) {
+            for (std::size_t k = 0; k < kLanes; ++k) {
+                out[base + k * block + j] = s[k];
+                double s2 = s[k] * cs + c[k] * sn;
+                c[k] = c[k] * cs - s[k] * sn;
+                s[k] = s2;
+            }
+        }
+    }
+
+    for (; base < n; base += block) {
+        std::size_t end = std::min(n, base + block);
+        double phase = phase0 + step * static_cast<double>(base);
+        double s = std::sin(phase);
+        double c = std::cos(phase);
+        for (std::size_t i = base; i < end; ++i) {
+            out[i] = s;
+            double s2 = s * cs + c * sn;
+            c = c * cs - s * sn;
+            s = s2;
+        }
+    }
+}
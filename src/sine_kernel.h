@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+// Batch sine: out[i] = sin(in[i]) for i in [0, n).  in and out may alias.
+// The kernel (AVX2+FMA, SSE2 or portable scalar) is picked once at runtime
+// from the host CPU.  Absolute error is below 1e-13 for |x| < 1e8; larger
+// and non-finite inputs fall back to std::sin.
+void sin_batch(const double* in, double* out, std::size_t n);
+
+// Name of the kernel in use: "avx2", "sse2" or "scalar".
+const char* sin_batch_isa();
+
+// Uniform-step sine sequence: out[i] = sin(phase0 + i * step).
+// Uses the rotation recurrence
+//     s' = s*cos(step) + c*sin(step),   c' = c*cos(step) - s*sin(step)
+// and reseeds (s, c) from libm every kSinSequenceReseed samples, so the
+// drift never accumulates past that block: absolute error stays below 1e-13.
+static constexpr std::size_t kSinSequenceReseed = 64;
+void sin_sequence(double phase0, double step, std::size_t n, double* out);
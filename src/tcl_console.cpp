@@ -1,43 +1,63 @@
 #include "tcl_console.h"
 #include "graph_window.h"
 #include "plugin_process.h"
+#include "tcl_graph_cmd.h"
+#include "ui_thread.h"
+
+#include <FL/Fl.H>
 
-#include <cmath>
 #include <cstring>
 #include <string>
 
-TclConsole::TclConsole() = default;
+// Link hooks: pull blocks for a snapshot like `graph get`; push only
+// posts, since it also runs from the executor's done hook.
+static bool pull_params(GraphParams& out) {
+    bool have_window = false;
+    bool ran = run_on_ui_thread([&] {
+        if (auto* gw = get_graph_window()) { out = gw->params(); have_window = true; }
+    });
+    return ran && have_window;
+}
+
+static void push_params(const GraphParams& values, unsigned dirty) {
+    post_to_ui_thread([values, dirty] {
+        auto* gw = get_graph_window();
+        if (!gw) return;
+        for (const ParamDesc& d : kParamDescs)
+            if (dirty & (1u << static_cast<unsigned>(d.id)))
+                gw->params().set(d.id, values.get(d.id));
+        gw->show();
+        gw->sync_and_redraw();
+    });
+}
+
+TclConsole::TclConsole()
+    : link_({pull_params, push_params}),
+      exec_({[this](Tcl_Interp* interp) { register_commands(interp); },
+             [this] { link_.flush(); link_.invalidate(); },
+             output_ready, this})
+{}
 
 TclConsole::~TclConsole() {
-    if (interp_) {
-        Tcl_DeleteInterp(interp_);
-        interp_ = nullptr;
-    }
+    shutdown();
     delete win_;
 }
 
-void TclConsole::init_interp() {
-    Tcl_FindExecutable(nullptr);
-    interp_ = Tcl_CreateInterp();
-    if (Tcl_Init(interp_) != TCL_OK) {
-        const char* err = Tcl_GetStringResult(interp_);
-        if (win_) {
-            win_->append_output("Tcl_Init error: ");
-            win_->append_output(err);
-            win_->append_output("\n");
-        }
-    }
+void TclConsole::shutdown() {
+    exec_.shutdown();
+}
 
-    Tcl_CreateObjCommand(interp_, "puts", puts_cmd,
-                         static_cast<ClientData>(this), nullptr);
-    Tcl_CreateObjCommand(interp_, "app_info", app_info_cmd,
+// Runs on the executor thread, which owns the interp.
+void TclConsole::register_commands(Tcl_Interp* interp) {
+    Tcl_CreateObjCommand(interp, "app_info", app_info_cmd,
                          static_cast<ClientData>(this), nullptr);
-    Tcl_CreateObjCommand(interp_, "graph", graph_cmd,
+    Tcl_CreateObjCommand(interp, "graph", graph_cmd,
                          static_cast<ClientData>(this), nullptr);
-    Tcl_CreateObjCommand(interp_, "launch_tk_plugin", launch_plugin_cmd,
+    Tcl_CreateObjCommand(interp, "launch_tk_plugin", launch_plugin_cmd,
                          reinterpret_cast<ClientData>(0), nullptr);
-    Tcl_CreateObjCommand(interp_, "launch_tkinter_plugin", launch_plugin_cmd,
+    Tcl_CreateObjCommand(interp, "launch_tkinter_plugin", launch_plugin_cmd,
                          reinterpret_cast<ClientData>(1), nullptr);
+    link_.attach(interp);
 }
 
 void TclConsole::ensure_init() {
@@ -45,11 +65,10 @@ void TclConsole::ensure_init() {
         win_ = new ConsoleWindow(600, 400, "Tcl Console");
         win_->set_prompt("% ");
         win_->set_command_callback([this](const char* cmd) { on_command(cmd); });
-    }
-    if (!interp_) {
-        init_interp();
+        win_->set_interrupt_callback([this] { on_interrupt(); });
         win_->append_output("Tcl " TCL_VERSION " ready.\n");
     }
+    exec_.start();
 }
 
 void TclConsole::show() {
@@ -62,162 +81,109 @@ void TclConsole::show() {
 void TclConsole::on_command(const char* cmd) {
     std::string echo = std::string("% ") + cmd + "\n";
     win_->append_output(echo.c_str());
-
-    int rc = Tcl_Eval(interp_, cmd);
-    const char* result = Tcl_GetStringResult(interp_);
-
-    if (result && result[0] != '\0') {
-        if (rc == TCL_ERROR) {
-            std::string err = std::string("ERROR: ") + result + "\n";
-            win_->append_output(err.c_str());
-        } else {
-            std::string out = std::string(result) + "\n";
-            win_->append_output(out.c_str());
-        }
-    }
+    win_->flush();
+    exec_.submit(cmd);
 }
 
-// ── Custom puts ─────────────────────────────────────────────────
-int TclConsole::puts_cmd(ClientData cd, Tcl_Interp* interp,
-                         int objc, Tcl_Obj* const objv[])
-{
-    auto* self = static_cast<TclConsole*>(cd);
-
-    bool newline = true;
-    int strIdx = 1;
-
-    if (objc >= 2) {
-        const char* first = Tcl_GetString(objv[1]);
-        if (std::strcmp(first, "-nonewline") == 0) {
-            newline = false;
-            strIdx = 2;
-        }
-    }
-
-    int remaining = objc - strIdx;
-    if (remaining == 2) {
-        strIdx += 1;
-    } else if (remaining < 1) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(
-            "wrong # args: should be \"puts ?-nonewline? ?channelId? string\"", -1));
-        return TCL_ERROR;
-    }
+void TclConsole::on_interrupt() {
+    if (exec_.busy()) win_->append_output("^C\n");
+    exec_.cancel();
+}
 
-    const char* str = Tcl_GetString(objv[strIdx]);
-    if (self->win_) {
-        self->win_->append_output(str);
-        if (newline) self->win_->append_output("\n");
-    }
-    return TCL_OK;
+void TclConsole::flush_output() {
+    std::string text = exec_.take_output();
+    if (!text.empty()) win_->append_output(text.c_str());
 }
 
-// ── app_info ────────────────────────────────────────────────────
-int TclConsole::app_info_cmd(ClientData, Tcl_Interp* interp,
-                             int, Tcl_Obj* const*)
-{
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(
-        "FLTK Console App with embedded Tcl & Python", -1));
-    return TCL_OK;
+// Executor hook, on the interpreter thread: drain on the UI thread.
+void TclConsole::output_ready(void* data) {
+    Fl::awake(flush_cb, data);
 }
 
-// ── launch_plugin (tk=0, tkinter=1 via ClientData) ──────────────
-int TclConsole::launch_plugin_cmd(ClientData cd, Tcl_Interp*,
-                                  int, Tcl_Obj* const*)
-{
-    if (reinterpret_cast<intptr_t>(cd) == 0)
-        launch_tk_graph_plugin();
-    else
-        launch_tkinter_graph_plugin();
-    return TCL_OK;
+void TclConsole::flush_cb(void* data) {
+    auto* self = static_cast<TclConsole*>(data);
+    if (self->win_) self->flush_output();
 }
 
-// ── graph command ───────────────────────────────────────────────
-int TclConsole::graph_cmd(ClientData, Tcl_Interp* interp,
-                          int objc, Tcl_Obj* const objv[])
+// ── app_info ────────────────────────────────────────────────────
+// `app_info` describes the app; `app_info cache` reports the console's
+// script cache and `app_info scrollback ?lines?` its output log (setting
+// the line limit first if given), each as a dict.  The scrollback readout
+// is Tcl-only; the Python console keeps Scrollback::kDefaultLimit.
+int TclConsole::app_info_cmd(ClientData cd, Tcl_Interp* interp,
+                             int objc, Tcl_Obj* const objv[])
 {
-    if (objc < 2) {
+    if (objc == 1) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj(
-            "usage: graph set|get|params|preset|eval ...", -1));
-        return TCL_ERROR;
-    }
-
-    auto* gw = get_graph_window();
-    if (!gw) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj("graph window not available", -1));
-        return TCL_ERROR;
-    }
-
-    const char* sub = Tcl_GetString(objv[1]);
-
-    if (std::strcmp(sub, "set") == 0) {
-        if (objc != 4) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("usage: graph set <param> <value>", -1));
-            return TCL_ERROR;
-        }
-        double value;
-        if (Tcl_GetDoubleFromObj(interp, objv[3], &value) != TCL_OK) return TCL_ERROR;
-        if (!gw->params().set(Tcl_GetString(objv[2]), value)) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("unknown parameter", -1));
-            return TCL_ERROR;
-        }
-        gw->show();
-        gw->sync_and_redraw();
+            "FLTK Console App with embedded Tcl & Python", -1));
         return TCL_OK;
     }
-
-    if (std::strcmp(sub, "get") == 0) {
-        if (objc != 3) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("usage: graph get <param>", -1));
+    auto* self = static_cast<TclConsole*>(cd);
+    const char* what = Tcl_GetString(objv[1]);
+    Tcl_Obj* dict = nullptr;
+    auto put = [&](const char* k, unsigned long v) {
+        if (!dict) dict = Tcl_NewDictObj();
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj(k, -1),
+                       Tcl_NewWideIntObj(static_cast<Tcl_WideInt>(v)));
+    };
+
+    if ((objc == 2 || objc == 3) && std::strcmp(what, "scrollback") == 0) {
+        Tcl_WideInt limit = -1;
+        if (objc == 3 && (Tcl_GetWideIntFromObj(interp, objv[2], &limit) != TCL_OK || limit < 0)) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("scrollback limit must be >= 0", -1));
             return TCL_ERROR;
         }
-        double v = gw->params().get(Tcl_GetString(objv[2]));
-        if (std::isnan(v)) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("unknown parameter", -1));
+        ScrollbackStats st;
+        if (!run_on_ui_thread([&] {
+                if (limit >= 0) self->win_->set_scrollback_limit(static_cast<std::size_t>(limit));
+                self->win_->flush();
+                st = self->win_->scrollback_stats();
+            })) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("UI thread is not running", -1));
             return TCL_ERROR;
         }
-        Tcl_SetObjResult(interp, Tcl_NewDoubleObj(v));
-        return TCL_OK;
-    }
-
-    if (std::strcmp(sub, "params") == 0) {
-        auto all = gw->params().all();
-        Tcl_Obj* dict = Tcl_NewDictObj();
-        for (auto& [k, v] : all)
-            Tcl_DictObjPut(interp, dict,
-                           Tcl_NewStringObj(k.c_str(), -1), Tcl_NewDoubleObj(v));
+        put("lines",       st.lines);
+        put("bytes",       st.bytes);
+        put("index_bytes", st.index_bytes);
+        put("limit",       st.limit);
+        put("trimmed",     st.trimmed);
         Tcl_SetObjResult(interp, dict);
         return TCL_OK;
     }
 
-    if (std::strcmp(sub, "preset") == 0) {
-        if (objc != 3) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj(
-                "usage: graph preset <name>  (circle, figure8, lissajous, star, bowtie)", -1));
-            return TCL_ERROR;
-        }
-        if (!gw->params().load_preset(Tcl_GetString(objv[2]))) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("unknown preset", -1));
-            return TCL_ERROR;
-        }
-        gw->show();
-        gw->sync_and_redraw();
-        return TCL_OK;
+    if (objc != 2 || std::strcmp(what, "cache") != 0) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("usage: app_info ?cache|scrollback ?lines??", -1));
+        return TCL_ERROR;
     }
+    ScriptCacheStats st = self->exec_.cache_stats();
+    put("hits",     st.hits);
+    put("misses",   st.misses);
+    put("size",     st.size);
+    put("capacity", st.capacity);
+    Tcl_SetObjResult(interp, dict);
+    return TCL_OK;
+}
 
-    if (std::strcmp(sub, "eval") == 0) {
-        if (objc != 3) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("usage: graph eval <t>", -1));
-            return TCL_ERROR;
-        }
-        double t;
-        if (Tcl_GetDoubleFromObj(interp, objv[2], &t) != TCL_OK) return TCL_ERROR;
-        auto [px, py] = gw->params().eval(t);
-        Tcl_Obj* elems[2] = { Tcl_NewDoubleObj(px), Tcl_NewDoubleObj(py) };
-        Tcl_SetObjResult(interp, Tcl_NewListObj(2, elems));
-        return TCL_OK;
+// ── launch_plugin (tk=0, tkinter=1 via ClientData) ──────────────
+int TclConsole::launch_plugin_cmd(ClientData cd, Tcl_Interp* interp,
+                                  int, Tcl_Obj* const*)
+{
+    bool tk = reinterpret_cast<intptr_t>(cd) == 0;
+    if (!run_on_ui_thread(tk ? launch_tk_graph_plugin : launch_tkinter_graph_plugin)) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("UI thread is not running", -1));
+        return TCL_ERROR;
     }
+    return TCL_OK;
+}
 
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(
-        "unknown subcommand: use set|get|params|preset|eval", -1));
-    return TCL_ERROR;
+// Linked-array writes reach the UI before the subcommand runs, and the
+// next graph_params read sees whatever it changed.
+int TclConsole::graph_cmd(ClientData cd, Tcl_Interp* interp,
+                          int objc, Tcl_Obj* const objv[])
+{
+    TclParamLink& link = static_cast<TclConsole*>(cd)->link_;
+    link.flush();
+    int rc = graph_command(graph_window_handle(), interp, objc, objv);
+    link.invalidate();
+    return rc;
 }
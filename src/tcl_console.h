@@ -1,8 +1,14 @@
 #pragma once
 
 #include "console_window.h"
-#include <tcl.h>
+#include "tcl_executor.h"
+#include "tcl_param_link.h"
 
+// Tcl console window.  The interpreter lives on a TclExecutor thread, so
+// long scripts never block the FLTK loop; `puts` output streams in as it
+// is written and Ctrl+C in the input field cancels the running script.
+// The graph parameters are also linked into the interp as the array
+// graph_params (see TclParamLink).
 class TclConsole {
 public:
     TclConsole();
@@ -10,13 +16,19 @@ public:
 
     void show();
 
+    // Cancel the running script and stop the interpreter thread.  Call on
+    // the UI thread after Fl::run() returns and ui_thread_shutdown().
+    void shutdown();
+
 private:
     void ensure_init();
-    void init_interp();
     void on_command(const char* cmd);
+    void on_interrupt();
+    void flush_output();
+    static void output_ready(void* data);
+    static void flush_cb(void* data);
+    void register_commands(Tcl_Interp* interp);
 
-    static int puts_cmd(ClientData cd, Tcl_Interp* interp,
-                        int objc, Tcl_Obj* const objv[]);
     static int app_info_cmd(ClientData cd, Tcl_Interp* interp,
                             int objc, Tcl_Obj* const objv[]);
     static int graph_cmd(ClientData cd, Tcl_Interp* interp,
@@ -24,6 +36,7 @@ private:
     static int launch_plugin_cmd(ClientData cd, Tcl_Interp* interp,
                                  int objc, Tcl_Obj* const objv[]);
 
-    ConsoleWindow* win_    = nullptr;
-    Tcl_Interp*    interp_ = nullptr;
+    ConsoleWindow* win_ = nullptr;
+    TclParamLink   link_;       // used on the executor thread; outlives exec_
+    TclExecutor    exec_;
 };
@@ -0,0 +1,181 @@
+#include "tcl_executor.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+// Shared with the worker, which keeps it alive if shutdown() detaches it.
+struct TclExecutor::State {
+    Hooks                   hooks;
+    std::mutex              mu;
+    std::condition_variable cv;
+    std::deque<std::string> queue;              // guarded by mu
+    std::string             output;             // guarded by mu
+    Tcl_Interp*             interp   = nullptr; // guarded by mu (for cancel)
+    TclScriptCache          cache;              // worker only, except stats()
+    bool                    quit     = false;
+    bool                    finished = false;
+    std::atomic<bool>       busy{false};
+
+    // Append text; notify on the first write since the last take.
+    void write(const char* text, std::size_t len) {
+        bool first;
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            first = output.empty();
+            output.append(text, len);
+        }
+        if (first && hooks.output_ready) hooks.output_ready(hooks.ctx);
+    }
+    void write(const std::string& text) { write(text.data(), text.size()); }
+};
+
+TclExecutor::TclExecutor(Hooks hooks) : st_(std::make_shared<State>()) {
+    st_->hooks = std::move(hooks);
+}
+
+TclExecutor::~TclExecutor() { shutdown(); }
+
+bool TclExecutor::busy() const { return st_->busy; }
+
+ScriptCacheStats TclExecutor::cache_stats() const { return st_->cache.stats(); }
+
+void TclExecutor::start() {
+    if (thread_.joinable()) return;
+    thread_ = std::thread(run, st_);
+}
+
+void TclExecutor::submit(std::string script) {
+    {
+        std::lock_guard<std::mutex> lk(st_->mu);
+        st_->queue.push_back(std::move(script));
+    }
+    st_->cv.notify_all();
+}
+
+void TclExecutor::cancel() {
+    std::lock_guard<std::mutex> lk(st_->mu);
+    st_->queue.clear();
+    // Tcl_CancelEval is the one interp call allowed from another thread.
+    if (st_->busy && st_->interp)
+        Tcl_CancelEval(st_->interp, nullptr, nullptr, TCL_CANCEL_UNWIND);
+}
+
+std::string TclExecutor::take_output() {
+    std::lock_guard<std::mutex> lk(st_->mu);
+    std::string text;
+    text.swap(st_->output);
+    return text;
+}
+
+void TclExecutor::shutdown(std::chrono::milliseconds timeout) {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lk(st_->mu);
+        st_->quit = true;
+    }
+    st_->cv.notify_all();
+    cancel();
+
+    std::unique_lock<std::mutex> lk(st_->mu);
+    bool stopped = st_->cv.wait_for(lk, timeout, [&] { return st_->finished; });
+    lk.unlock();
+    if (stopped) thread_.join();
+    else         thread_.detach();
+}
+
+// ── Worker thread ───────────────────────────────────────────────
+
+// Console puts: ?-nonewline? ?channelId? string.  The channel is ignored;
+// everything goes to the console, as soon as it is written.
+int TclExecutor::puts_cmd(ClientData cd, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    auto* st = static_cast<State*>(cd);
+
+    bool newline = true;
+    int strIdx = 1;
+
+    if (objc >= 2 && std::strcmp(Tcl_GetString(objv[1]), "-nonewline") == 0) {
+        newline = false;
+        strIdx = 2;
+    }
+
+    int remaining = objc - strIdx;
+    if (remaining == 2) {
+        strIdx += 1;
+    } else if (remaining != 1) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(
+            "wrong # args: should be \"puts ?-nonewline? ?channelId? string\"", -1));
+        return TCL_ERROR;
+    }
+
+    Tcl_Size len;
+    const char* str = Tcl_GetStringFromObj(objv[strIdx], &len);
+    std::string line(str, static_cast<std::size_t>(len));
+    if (newline) line += '\n';
+    st->write(line);
+    return TCL_OK;
+}
+
+void TclExecutor::run(std::shared_ptr<State> st) {
+    Tcl_FindExecutable(nullptr);
+    Tcl_Interp* interp = Tcl_CreateInterp();
+    if (Tcl_Init(interp) != TCL_OK)
+        st->write(std::string("Tcl_Init error: ") + Tcl_GetStringResult(interp) + "\n");
+    Tcl_CreateObjCommand(interp, "puts", puts_cmd, static_cast<ClientData>(st.get()), nullptr);
+    if (st->hooks.setup) st->hooks.setup(interp);
+    {
+        std::lock_guard<std::mutex> lk(st->mu);
+        st->interp = interp;
+    }
+
+    Tcl_Obj* empty = Tcl_NewObj();
+    Tcl_IncrRefCount(empty);
+
+    for (;;) {
+        std::string script;
+        {
+            std::unique_lock<std::mutex> lk(st->mu);
+            st->cv.wait(lk, [&] { return st->quit || !st->queue.empty(); });
+            if (st->quit) break;
+            script = std::move(st->queue.front());
+            st->queue.pop_front();
+            st->busy = true;
+        }
+        // Tcl_EvalObjEx (unlike Tcl_EvalEx) clears the cancel flags when
+        // the level-0 eval returns, so the next script starts clean.
+        Tcl_Obj* obj = st->cache.acquire(script);
+        int rc = Tcl_EvalObjEx(interp, obj, TCL_EVAL_GLOBAL);
+        Tcl_DecrRefCount(obj);
+        {
+            std::lock_guard<std::mutex> lk(st->mu);
+            st->busy = false;
+        }
+
+        const char* result = Tcl_GetStringResult(interp);
+        if (result && result[0] != '\0')
+            st->write(std::string(rc == TCL_ERROR ? "ERROR: " : "") + result + "\n");
+        // A cancel() that landed between the eval returning and busy
+        // clearing is still pending; an empty eval absorbs it.
+        Tcl_EvalObjEx(interp, empty, TCL_EVAL_GLOBAL);
+        Tcl_ResetResult(interp);
+        if (st->hooks.done) st->hooks.done();
+    }
+
+    Tcl_DecrRefCount(empty);
+    st->cache.clear();
+    {
+        std::lock_guard<std::mutex> lk(st->mu);
+        st->interp = nullptr;
+    }
+    Tcl_DeleteInterp(interp);
+    Tcl_FinalizeThread();
+
+    {
+        std::lock_guard<std::mutex> lk(st->mu);
+        st->finished = true;
+    }
+    st->cv.notify_all();
+}
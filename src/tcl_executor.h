@@ -0,0 +1,69 @@
+#pragma once
+
+#include "tcl_script_cache.h"
+
+#include <tcl.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Runs a Tcl interpreter on its own thread.
+//
+// A Tcl_Interp is bound to the thread that created it, so the worker
+// creates, uses and deletes it.  Scripts queued by submit() run one at a
+// time with Tcl_EvalObjEx on objects from a TclScriptCache, so repeated
+// commands keep their bytecode; each result (or "ERROR: ...") is appended to the
+// output after the script's own `puts` text, which the executor's `puts`
+// streams as it is produced.  take_output() drains it from any thread.
+//
+// Hooks run on the worker thread and must only post to the UI (e.g.
+// Fl::awake), never block on it.
+class TclExecutor {
+public:
+    struct Hooks {
+        std::function<void(Tcl_Interp*)> setup;         // after Tcl_Init: register commands
+        std::function<void()>            done;          // after each script
+        void (*output_ready)(void* ctx) = nullptr;      // first output since the last take
+        void* ctx                       = nullptr;
+    };
+
+    explicit TclExecutor(Hooks hooks);
+    ~TclExecutor();
+
+    TclExecutor(const TclExecutor&)            = delete;
+    TclExecutor& operator=(const TclExecutor&) = delete;
+
+    // Start the worker (once).
+    void start();
+
+    // Queue one console script.
+    void submit(std::string script);
+
+    // Unwind the running script with Tcl_CancelEval (TCL_CANCEL_UNWIND, so
+    // `catch` cannot swallow it) and drop queued ones.
+    void cancel();
+
+    // Everything printed since the last call, in order.
+    std::string take_output();
+
+    // True while a script is executing.
+    bool busy() const;
+
+    // Script cache counters; callable from any thread.
+    ScriptCacheStats cache_stats() const;
+
+    // Cancel, stop the worker and delete the interp.  A worker that does
+    // not stop within `timeout` is detached.
+    void shutdown(std::chrono::milliseconds timeout = std::chrono::seconds(2));
+
+private:
+    struct State;
+    static void run(std::shared_ptr<State> st);
+    static int  puts_cmd(ClientData cd, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
+
+    std::shared_ptr<State> st_;
+    std::thread            thread_;
+};
@@ -0,0 +1,434 @@
+#include "tcl_graph_cmd.h"
+#include "graph_raster.h"
+#include "param_sweep.h"
+#include "tcl_script_cache.h"   // Tcl_Size on 8.6
+#include "ui_thread.h"
+
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// ── UI-thread access ────────────────────────────────────────────
+// The graph belongs to the UI thread and the command runs on the
+// interpreter thread: run fn(live params) over there.  Tcl objects stay
+// here.
+static int with_graph(Tcl_Interp* interp, const GraphHandle& g,
+                      const std::function<void(GraphParams&)>& fn) {
+    bool have_window = false;
+    bool ran = run_on_ui_thread([&] {
+        if (GraphParams* p = g.params()) { fn(*p); have_window = true; }
+    });
+    if (!ran || !have_window) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(
+            ran ? "graph window not available" : "UI thread is not running", -1));
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+// Cancellation predicate for the long subcommands (render, sweep): Ctrl+C
+// in the console is TclExecutor::cancel(), i.e. Tcl_CancelEval.  That
+// arrives as an async event, which the bytecode engine would deliver
+// between commands; deliver it here, then ask Tcl_Canceled.  Polled on
+// this, the interp's, thread only.  Once it fires `fired` stays set and
+// the result holds Tcl's "eval canceled" / "eval unwound" message.
+static std::function<bool()> cancel_poll(Tcl_Interp* interp, bool& fired) {
+    return [interp, &fired] {
+        if (fired) return true;
+        if (Tcl_AsyncReady() && Tcl_AsyncInvoke(interp, TCL_OK) != TCL_OK)
+            fired = true;
+        else
+            fired = Tcl_Canceled(interp, TCL_LEAVE_ERR_MSG) == TCL_ERROR;
+        return fired;
+    };
+}
+
+// ── graph word tables ───────────────────────────────────────────
+// nullptr-terminated and in enum order, as Tcl_GetIndexFromObj expects.
+// All three are looked up with TCL_EXACT: the words were matched with
+// strcmp before, so abbreviations like `graph se` stay errors.
+enum class GraphSub { set, get, params, preset, eval, sampling, engine, stats, render, sweep };
+static const char* const kGraphSubcommands[] = {
+    "set", "get", "params", "preset", "eval", "sampling", "engine", "stats", "render", "sweep",
+    nullptr
+};
+
+enum { kSweepA, kSweepB, kSweepAmpA, kSweepAmpB, kSweepDelta,
+       kSweepReduce, kSweepPoints, kSweepThreads };
+static const char* const kSweepOptions[] = {
+    "-a", "-b", "-A", "-B", "-delta", "-reduce", "-points", "-threads", nullptr
+};
+
+// Parameter name → ParamId, cached in the word like the subcommand.
+static int get_param_id(Tcl_Interp* interp, Tcl_Obj* obj, ParamId& id) {
+    int index;
+    if (Tcl_GetIndexFromObj(interp, obj, GraphParams::kParamNames.data(), "parameter",
+                            TCL_EXACT, &index) != TCL_OK)
+        return TCL_ERROR;
+    id = static_cast<ParamId>(index);
+    return TCL_OK;
+}
+
+// ── graph sweep helpers ─────────────────────────────────────────
+// A range is either a single value or a {lo hi steps} list.
+static int get_sweep_range(Tcl_Interp* interp, Tcl_Obj* obj, SweepRange& r) {
+    Tcl_Size n;
+    Tcl_Obj** elems;
+    if (Tcl_ListObjGetElements(interp, obj, &n, &elems) != TCL_OK) return TCL_ERROR;
+    if (n == 1) {
+        if (Tcl_GetDoubleFromObj(interp, elems[0], &r.lo) != TCL_OK) return TCL_ERROR;
+        r.hi = r.lo;
+        r.steps = 1;
+        return TCL_OK;
+    }
+    if (n != 3) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("sweep range must be value or {lo hi steps}", -1));
+        return TCL_ERROR;
+    }
+    if (Tcl_GetDoubleFromObj(interp, elems[0], &r.lo) != TCL_OK ||
+        Tcl_GetDoubleFromObj(interp, elems[1], &r.hi) != TCL_OK ||
+        Tcl_GetIntFromObj(interp, elems[2], &r.steps) != TCL_OK)
+        return TCL_ERROR;
+    if (r.steps < 1) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("sweep steps must be >= 1", -1));
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+static Tcl_Obj* sweep_result_obj(Tcl_Interp* interp, const SweepResult& r, SweepReducer red) {
+    Tcl_Obj* dict = Tcl_NewDictObj();
+    auto put = [&](const char* k, Tcl_Obj* v) {
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj(k, -1), v);
+    };
+    put("a", Tcl_NewDoubleObj(r.a));
+    put("b", Tcl_NewDoubleObj(r.b));
+    put("A", Tcl_NewDoubleObj(r.A));
+    put("B", Tcl_NewDoubleObj(r.B));
+    put("delta", Tcl_NewDoubleObj(r.delta));
+    switch (red) {
+    case SweepReducer::bbox:
+        put("xmin", Tcl_NewDoubleObj(r.xmin));
+        put("xmax", Tcl_NewDoubleObj(r.xmax));
+        put("ymin", Tcl_NewDoubleObj(r.ymin));
+        put("ymax", Tcl_NewDoubleObj(r.ymax));
+        break;
+    case SweepReducer::arclength:
+        put("length", Tcl_NewDoubleObj(r.length));
+        break;
+    case SweepReducer::selfintersections:
+        put("crossings", Tcl_NewWideIntObj(r.crossings));
+        break;
+    }
+    return dict;
+}
+
+// ── graph command ───────────────────────────────────────────────
+int graph_command(const GraphHandle& g, Tcl_Interp* interp,
+                  int objc, Tcl_Obj* const objv[])
+{
+    if (objc < 2) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(
+            "usage: graph set|get|params|preset|eval|sampling|engine|stats|render|sweep ...", -1));
+        return TCL_ERROR;
+    }
+
+    // Tcl_GetIndexFromObj caches the match in the word's internal rep, so
+    // a `graph set delta $d` loop resolves both words once.
+    int index;
+    if (Tcl_GetIndexFromObj(interp, objv[1], kGraphSubcommands, "subcommand", TCL_EXACT,
+                            &index) != TCL_OK)
+        return TCL_ERROR;
+    const auto sub = static_cast<GraphSub>(index);
+
+    GraphParams params;     // snapshot for the read-only subcommands
+    auto snapshot = [&] {
+        return with_graph(interp, g, [&](GraphParams& p) { params = p; });
+    };
+
+    if (sub == GraphSub::set) {
+        if (objc != 4) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("usage: graph set <param> <value>", -1));
+            return TCL_ERROR;
+        }
+        ParamId id;
+        double value;
+        if (get_param_id(interp, objv[2], id) != TCL_OK ||
+            Tcl_GetDoubleFromObj(interp, objv[3], &value) != TCL_OK)
+            return TCL_ERROR;
+        return with_graph(interp, g, [&](GraphParams& p) {
+            p.set(id, value);
+            g.changed(true);
+        });
+    }
+
+    if (sub == GraphSub::get) {
+        if (objc != 3) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("usage: graph get <param>", -1));
+            return TCL_ERROR;
+        }
+        ParamId id;
+        if (get_param_id(interp, objv[2], id) != TCL_OK || snapshot() != TCL_OK)
+            return TCL_ERROR;
+        Tcl_SetObjResult(interp, Tcl_NewDoubleObj(params.get(id)));
+        return TCL_OK;
+    }
+
+    if (sub == GraphSub::params) {
+        if (snapshot() != TCL_OK) return TCL_ERROR;
+        Tcl_Obj* dict = Tcl_NewDictObj();
+        for (const ParamValue& pv : params.values())
+            Tcl_DictObjPut(interp, dict,
+                           Tcl_NewStringObj(pv.name, -1), Tcl_NewDoubleObj(pv.value));
+        Tcl_SetObjResult(interp, dict);
+        return TCL_OK;
+    }
+
+    if (sub == GraphSub::preset) {
+        if (objc != 3) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj(
+                "usage: graph preset <name>  (circle, figure8, lissajous, star, bowtie)", -1));
+            return TCL_ERROR;
+        }
+        const char* name = Tcl_GetString(objv[2]);
+        bool known = false;
+        if (with_graph(interp, g, [&](GraphParams& p) {
+                if ((known = p.load_preset(name))) g.changed(true);
+            }) != TCL_OK)
+            return TCL_ERROR;
+        if (!known) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("unknown preset", -1));
+            return TCL_ERROR;
+        }
+        return TCL_OK;
+    }
+
+    if (sub == GraphSub::eval) {
+        static const char* usage =
+            "usage: graph eval <t> | graph eval ?-bytes? -list {t ...} | "
+            "graph eval ?-bytes? -range <t0> <t1> <n>";
+        int i = 2;
+        bool bytes = false;
+        if (i < objc && std::strcmp(Tcl_GetString(objv[i]), "-bytes") == 0) {
+            bytes = true;
+            ++i;
+        }
+        const char* form = i < objc ? Tcl_GetString(objv[i]) : "";
+        if (snapshot() != TCL_OK) return TCL_ERROR;
+
+        if (!bytes && objc == 3) {
+            double t;
+            if (Tcl_GetDoubleFromObj(interp, objv[2], &t) != TCL_OK) return TCL_ERROR;
+            auto [px, py] = params.eval(t);
+            Tcl_Obj* elems[2] = { Tcl_NewDoubleObj(px), Tcl_NewDoubleObj(py) };
+            Tcl_SetObjResult(interp, Tcl_NewListObj(2, elems));
+            return TCL_OK;
+        }
+
+        // Bulk forms: evaluate into SoA scratch, return x0 y0 x1 y1 ...
+        std::vector<double> xs, ys;
+        if (std::strcmp(form, "-list") == 0 && objc == i + 2) {
+            Tcl_Size n;
+            Tcl_Obj** elems;
+            if (Tcl_ListObjGetElements(interp, objv[i + 1], &n, &elems) != TCL_OK)
+                return TCL_ERROR;
+            std::vector<double> ts(static_cast<std::size_t>(n));
+            for (Tcl_Size k = 0; k < n; ++k)
+                if (Tcl_GetDoubleFromObj(interp, elems[k], &ts[k]) != TCL_OK) return TCL_ERROR;
+            xs.resize(ts.size());
+            ys.resize(ts.size());
+            params.eval_many(ts.data(), ts.size(), xs.data(), ys.data());
+        } else if (std::strcmp(form, "-range") == 0 && objc == i + 4) {
+            double t0, t1;
+            Tcl_WideInt n;
+            if (Tcl_GetDoubleFromObj(interp, objv[i + 1], &t0) != TCL_OK ||
+                Tcl_GetDoubleFromObj(interp, objv[i + 2], &t1) != TCL_OK ||
+                Tcl_GetWideIntFromObj(interp, objv[i + 3], &n) != TCL_OK)
+                return TCL_ERROR;
+            if (n < 0 || n > GraphParams::kMaxPoints) {
+                Tcl_SetObjResult(interp, Tcl_ObjPrintf(
+                    "sample count must be between 0 and %d", GraphParams::kMaxPoints));
+                return TCL_ERROR;
+            }
+            xs.resize(static_cast<std::size_t>(n));
+            ys.resize(static_cast<std::size_t>(n));
+            params.eval_range(t0, t1, xs.size(), xs.data(), ys.data());
+        } else {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj(usage, -1));
+            return TCL_ERROR;
+        }
+
+        const std::size_t n = xs.size();
+        if (bytes) {
+            // Packed native-endian doubles, interleaved like the list form.
+            std::vector<double> xy(n * 2);
+            for (std::size_t k = 0; k < n; ++k) {
+                xy[2 * k]     = xs[k];
+                xy[2 * k + 1] = ys[k];
+            }
+            Tcl_SetObjResult(interp, Tcl_NewByteArrayObj(
+                reinterpret_cast<const unsigned char*>(xy.data()),
+                static_cast<Tcl_Size>(xy.size() * sizeof(double))));
+            return TCL_OK;
+        }
+        std::vector<Tcl_Obj*> elems(n * 2);
+        for (std::size_t k = 0; k < n; ++k) {
+            elems[2 * k]     = Tcl_NewDoubleObj(xs[k]);
+            elems[2 * k + 1] = Tcl_NewDoubleObj(ys[k]);
+        }
+        Tcl_SetObjResult(interp, Tcl_NewListObj(static_cast<Tcl_Size>(elems.size()), elems.data()));
+        return TCL_OK;
+    }
+
+    if (sub == GraphSub::sampling) {
+        if (objc > 3) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj(
+                "usage: graph sampling ?uniform|adaptive?", -1));
+            return TCL_ERROR;
+        }
+        if (objc == 3) {
+            const char* name = Tcl_GetString(objv[2]);
+            bool known = false;
+            if (with_graph(interp, g, [&](GraphParams& p) {
+                    if ((known = p.set_sampling(name))) g.changed(false);
+                    params = p;
+                }) != TCL_OK)
+                return TCL_ERROR;
+            if (!known) {
+                Tcl_SetObjResult(interp, Tcl_NewStringObj(
+                    "unknown sampling mode (uniform, adaptive)", -1));
+                return TCL_ERROR;
+            }
+        } else if (snapshot() != TCL_OK) {
+            return TCL_ERROR;
+        }
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(params.sampling_name(), -1));
+        return TCL_OK;
+    }
+
+    if (sub == GraphSub::engine) {
+        if (objc > 3) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj(
+                "usage: graph engine ?simd|recurrence?", -1));
+            return TCL_ERROR;
+        }
+        if (objc == 3) {
+            const char* name = Tcl_GetString(objv[2]);
+            bool known = false;
+            if (with_graph(interp, g, [&](GraphParams& p) {
+                    if ((known = p.set_engine(name))) g.changed(false);
+                    params = p;
+                }) != TCL_OK)
+                return TCL_ERROR;
+            if (!known) {
+                Tcl_SetObjResult(interp, Tcl_NewStringObj(
+                    "unknown engine (simd, recurrence)", -1));
+                return TCL_ERROR;
+            }
+        } else if (snapshot() != TCL_OK) {
+            return TCL_ERROR;
+        }
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(params.engine_name(), -1));
+        return TCL_OK;
+    }
+
+    if (sub == GraphSub::stats) {
+        FrameStats st{};
+        if (with_graph(interp, g, [&](GraphParams&) { st = g.frame_stats(); }) != TCL_OK)
+            return TCL_ERROR;
+        Tcl_Obj* dict = Tcl_NewDictObj();
+        auto put = [&](const char* k, unsigned long v) {
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj(k, -1),
+                           Tcl_NewWideIntObj(static_cast<Tcl_WideInt>(v)));
+        };
+        put("requests", st.requests);
+        put("merged",   st.merged);
+        put("frames",   st.frames);
+        put("dropped",  st.dropped);
+        Tcl_SetObjResult(interp, dict);
+        return TCL_OK;
+    }
+
+    if (sub == GraphSub::render) {
+        if (objc != 5) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj(
+                "usage: graph render <file.ppm|file.png> <width> <height>", -1));
+            return TCL_ERROR;
+        }
+        int w, h;
+        if (Tcl_GetIntFromObj(interp, objv[3], &w) != TCL_OK) return TCL_ERROR;
+        if (Tcl_GetIntFromObj(interp, objv[4], &h) != TCL_OK) return TCL_ERROR;
+        if (snapshot() != TCL_OK) return TCL_ERROR;
+        bool canceled = false;
+        RgbaImage img = render_graph(params, w, h, cancel_poll(interp, canceled));
+        if (canceled) return TCL_ERROR;
+        if (img.px.empty()) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("image size out of range", -1));
+            return TCL_ERROR;
+        }
+        const char* path = Tcl_GetString(objv[2]);
+        if (!write_image(img, path)) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("could not write \"%s\"", path));
+            return TCL_ERROR;
+        }
+        return TCL_OK;
+    }
+
+    if (sub == GraphSub::sweep) {
+        static const char* usage =
+            "usage: graph sweep ?-a|-b|-A|-B|-delta {lo hi steps}? ...\n"
+            "       ?-reduce bbox|arclength|selfintersections? ?-points n? ?-threads n?";
+        if (snapshot() != TCL_OK) return TCL_ERROR;
+        SweepSpec spec = SweepSpec::around(params);
+        if ((objc - 2) % 2 != 0) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj(usage, -1));
+            return TCL_ERROR;
+        }
+        for (int i = 2; i < objc; i += 2) {
+            int opt;
+            if (Tcl_GetIndexFromObj(interp, objv[i], kSweepOptions, "option", TCL_EXACT,
+                                    &opt) != TCL_OK)
+                return TCL_ERROR;
+            Tcl_Obj*    val = objv[i + 1];
+            SweepRange* ranges[] = {&spec.a, &spec.b, &spec.A, &spec.B, &spec.delta};
+
+            if (opt <= kSweepDelta) {
+                if (get_sweep_range(interp, val, *ranges[opt]) != TCL_OK) return TCL_ERROR;
+            } else if (opt == kSweepReduce) {
+                if (!parse_reducer(Tcl_GetString(val), spec.reducer)) {
+                    Tcl_SetObjResult(interp, Tcl_NewStringObj(
+                        "unknown reducer (bbox, arclength, selfintersections)", -1));
+                    return TCL_ERROR;
+                }
+            } else if (opt == kSweepPoints) {
+                double pts;
+                if (Tcl_GetDoubleFromObj(interp, val, &pts) != TCL_OK) return TCL_ERROR;
+                spec.base.set(ParamId::points, pts);
+            } else {
+                int t;
+                if (Tcl_GetIntFromObj(interp, val, &t) != TCL_OK) return TCL_ERROR;
+                if (t < 0 || t > static_cast<int>(SweepSpec::kMaxThreads)) {
+                    Tcl_SetObjResult(interp, Tcl_ObjPrintf(
+                        "-threads must be between 0 and %u", SweepSpec::kMaxThreads));
+                    return TCL_ERROR;
+                }
+                spec.threads = static_cast<unsigned>(t);
+            }
+        }
+        if (spec.combinations() > SweepSpec::kMaxCombinations) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("too many sweep combinations", -1));
+            return TCL_ERROR;
+        }
+
+        bool canceled = false;
+        std::vector<SweepResult> results = run_sweep(spec, cancel_poll(interp, canceled));
+        if (canceled) return TCL_ERROR;
+        Tcl_Obj* list = Tcl_NewListObj(0, nullptr);
+        for (const SweepResult& r : results)
+            Tcl_ListObjAppendElement(interp, list, sweep_result_obj(interp, r, spec.reducer));
+        Tcl_SetObjResult(interp, list);
+        return TCL_OK;
+    }
+
+    return TCL_ERROR;   // not reached: every GraphSub returns above
+}
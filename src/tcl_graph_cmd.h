@@ -0,0 +1,12 @@
+#pragma once
+
+#include "graph_handle.h"
+
+#include <tcl.h>
+
+// The Tcl `graph` command: set|get|params|preset|eval|sampling|engine|
+// stats|render|sweep on the graph behind `g`.  Runs on the interpreter's
+// thread and reaches the graph through run_on_ui_thread().  No GUI
+// dependency, so it can be exercised without a window.
+int graph_command(const GraphHandle& g, Tcl_Interp* interp,
+                  int objc, Tcl_Obj* const objv[]);
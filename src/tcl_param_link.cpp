@@ -0,0 +1,88 @@
+#include "tcl_param_link.h"
+
+#include <string>
+#include <utility>
+
+TclParamLink::TclParamLink(Hooks hooks) : hooks_(std::move(hooks)) {}
+
+char* TclParamLink::field(ParamId id) {
+    switch (id) {
+    case ParamId::a:      return reinterpret_cast<char*>(&shadow_.a);
+    case ParamId::b:      return reinterpret_cast<char*>(&shadow_.b);
+    case ParamId::delta:  return reinterpret_cast<char*>(&shadow_.delta);
+    case ParamId::A:      return reinterpret_cast<char*>(&shadow_.A);
+    case ParamId::B:      return reinterpret_cast<char*>(&shadow_.B);
+    case ParamId::points: return reinterpret_cast<char*>(&shadow_.num_points);
+    }
+    return nullptr;
+}
+
+int TclParamLink::attach(Tcl_Interp* interp, const char* array) {
+    for (const ParamDesc& d : kParamDescs) {
+        std::string var = std::string(array) + "(" + d.name + ")";
+        int type = d.id == ParamId::points ? TCL_LINK_INT : TCL_LINK_DOUBLE;
+        if (Tcl_LinkVar(interp, var.c_str(), field(d.id), type) != TCL_OK)
+            return TCL_ERROR;
+    }
+    // Traces on the whole array run before the links' element traces.
+    return Tcl_TraceVar2(interp, array, nullptr,
+                         TCL_GLOBAL_ONLY | TCL_TRACE_READS | TCL_TRACE_WRITES,
+                         trace_cb, static_cast<ClientData>(this));
+}
+
+void TclParamLink::flush() {
+    if (!dirty_) return;
+    if (hooks_.push) hooks_.push(shadow_, dirty_);
+    dirty_     = 0;
+    last_push_ = Clock::now();
+}
+
+void TclParamLink::invalidate() {
+    stale_ = true;
+}
+
+// Pending writes go out first, so the pull (queued behind them) sees them.
+void TclParamLink::refresh() {
+    auto now = Clock::now();
+    if (!stale_ && now - last_pull_ < kInterval) return;
+    flush();
+    GraphParams live;
+    if (hooks_.pull && hooks_.pull(live)) shadow_ = live;
+    stale_     = false;
+    last_pull_ = now;
+}
+
+// The link's own trace has not stored the value yet, so parse it from the
+// variable the same way.  A value the link will reject is left alone.
+// set() clamps (points to 1..kMaxPoints), but the link then stores the
+// raw value over the shadow; a clamped write therefore marks the shadow
+// stale, so the next read pulls the clamped live value.
+void TclParamLink::store(Tcl_Interp* interp, const char* name1, const char* name2,
+                         ParamId id) {
+    Tcl_Obj* obj = Tcl_GetVar2Ex(interp, name1, name2, TCL_GLOBAL_ONLY);
+    if (!obj) return;
+    double v;
+    if (id == ParamId::points) {
+        int n;
+        if (Tcl_GetIntFromObj(nullptr, obj, &n) != TCL_OK) return;
+        v = n;
+    } else if (Tcl_GetDoubleFromObj(nullptr, obj, &v) != TCL_OK) {
+        return;
+    }
+    shadow_.set(id, v);
+    if (shadow_.get(id) != v) stale_ = true;
+    dirty_ |= 1u << static_cast<unsigned>(id);
+    if (Clock::now() - last_push_ >= kInterval) flush();
+}
+
+char* TclParamLink::trace_cb(ClientData cd, Tcl_Interp* interp,
+                             const char* name1, const char* name2, int flags) {
+    auto* self = static_cast<TclParamLink*>(cd);
+    ParamId id;
+    if (!name2 || !GraphParams::param_id(name2, id)) return nullptr;
+    if (flags & TCL_TRACE_READS)
+        self->refresh();
+    else if (flags & TCL_TRACE_WRITES)
+        self->store(interp, name1, name2, id);
+    return nullptr;
+}
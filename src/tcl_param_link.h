@@ -0,0 +1,63 @@
+#pragma once
+
+#include "graph_params.h"
+
+#include <tcl.h>
+
+#include <chrono>
+#include <functional>
+
+// Exposes the graph parameters to Tcl as the global array
+// graph_params(a|b|delta|A|B|points).
+//
+// The interp runs on the executor thread while the live GraphParams belong
+// to the UI thread, so each element is Tcl_LinkVar'ed to a shadow copy
+// owned by the interpreter thread.  Reads come straight from the shadow,
+// which is re-pulled from the UI after invalidate() or once kInterval has
+// passed.  Writes land in the shadow and mark the field dirty; dirty
+// fields are pushed at most once per kInterval and on flush(), so a tight
+// `set graph_params(delta) ...` loop costs one redraw per frame instead of
+// one `graph set` round trip per iteration.
+//
+// Every member must be called on the interpreter's thread.
+class TclParamLink {
+public:
+    struct Hooks {
+        std::function<bool(GraphParams&)> pull;   // copy the live params; false if unavailable
+        // Apply the fields whose bit (1 << ParamId) is set in `dirty`.
+        // Must not block on the UI thread.
+        std::function<void(const GraphParams&, unsigned dirty)> push;
+    };
+
+    static constexpr std::chrono::milliseconds kInterval{16};
+
+    explicit TclParamLink(Hooks hooks);
+
+    TclParamLink(const TclParamLink&)            = delete;
+    TclParamLink& operator=(const TclParamLink&) = delete;
+
+    // Create the linked array in interp.  The link must outlive interp.
+    int attach(Tcl_Interp* interp, const char* array = "graph_params");
+
+    // Push pending writes now.
+    void flush();
+
+    // The live params may have changed: the next read pulls them.
+    void invalidate();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static char* trace_cb(ClientData cd, Tcl_Interp* interp,
+                          const char* name1, const char* name2, int flags);
+    void  refresh();
+    void  store(Tcl_Interp* interp, const char* name1, const char* name2, ParamId id);
+    char* field(ParamId id);
+
+    Hooks             hooks_;
+    GraphParams       shadow_;
+    unsigned          dirty_ = 0;
+    bool              stale_ = true;
+    Clock::time_point last_pull_{};
+    Clock::time_point last_push_{};
+};
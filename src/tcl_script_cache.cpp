@@ -0,0 +1,45 @@
+#include "tcl_script_cache.h"
+
+TclScriptCache::TclScriptCache(std::size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1) {}
+
+TclScriptCache::~TclScriptCache() { clear(); }
+
+Tcl_Obj* TclScriptCache::acquire(const std::string& script) {
+    auto it = index_.find(script);
+    if (it != index_.end()) {
+        ++hits_;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        Tcl_Obj* obj = it->second->obj;
+        Tcl_IncrRefCount(obj);
+        return obj;
+    }
+
+    ++misses_;
+    Tcl_Obj* obj = Tcl_NewStringObj(script.data(), static_cast<Tcl_Size>(script.size()));
+    Tcl_IncrRefCount(obj);                      // caller's reference
+    if (script.size() > kMaxScriptBytes) return obj;
+
+    if (lru_.size() >= capacity_) {
+        Entry& old = lru_.back();
+        index_.erase(old.key);
+        Tcl_DecrRefCount(old.obj);
+        lru_.pop_back();
+    }
+    Tcl_IncrRefCount(obj);                      // the cache's reference
+    lru_.push_front({script, obj});
+    index_.emplace(script, lru_.begin());
+    size_ = lru_.size();
+    return obj;
+}
+
+void TclScriptCache::clear() {
+    for (Entry& e : lru_) Tcl_DecrRefCount(e.obj);
+    lru_.clear();
+    index_.clear();
+    size_ = 0;
+}
+
+ScriptCacheStats TclScriptCache::stats() const {
+    return {hits_, misses_, size_, capacity_};
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <tcl.h>
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// Tcl 8.6 predates Tcl_Size (list/string lengths are int there).
+#if TCL_MAJOR_VERSION < 9 && !defined(TCL_SIZE_MAX)
+typedef int Tcl_Size;
+#endif
+
+// Counters reported by TclScriptCache.
+struct ScriptCacheStats {
+    unsigned long hits     = 0;
+    unsigned long misses   = 0;   // includes scripts too large to cache
+    std::size_t   size     = 0;   // scripts currently cached
+    std::size_t   capacity = 0;
+};
+
+// Bounded LRU of script objects keyed by their text.
+//
+// Evaluating the same Tcl_Obj again with Tcl_EvalObjEx reuses the bytecode
+// kept in its internal rep, so a command recalled from history or replayed
+// in a loop is compiled once.  The cache holds one reference per entry.
+// Lookups and clear() must run on the interp's thread; stats() may be read
+// from any thread.
+class TclScriptCache {
+public:
+    static constexpr std::size_t kDefaultCapacity = 128;
+    static constexpr std::size_t kMaxScriptBytes  = 64 * 1024;  // larger ones bypass
+
+    explicit TclScriptCache(std::size_t capacity = kDefaultCapacity);
+    ~TclScriptCache();
+
+    TclScriptCache(const TclScriptCache&)            = delete;
+    TclScriptCache& operator=(const TclScriptCache&) = delete;
+
+    // Script object for `script`, marked most recently used.  The result
+    // carries a reference owned by the caller (Tcl_DecrRefCount when done),
+    // so eviction during evaluation is harmless.
+    Tcl_Obj* acquire(const std::string& script);
+
+    void clear();
+
+    ScriptCacheStats stats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        Tcl_Obj*    obj;
+    };
+    using List = std::list<Entry>;
+
+    std::size_t                                 capacity_;
+    List                                        lru_;        // front = most recent
+    std::unordered_map<std::string, List::iterator> index_;
+    std::atomic<unsigned long>                  hits_{0};
+    std::atomic<unsigned long>                  misses_{0};
+    std::atomic<std::size_t>                    size_{0};
+};
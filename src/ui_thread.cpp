@@ -0,0 +1,114 @@
+#include "ui_thread.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace {
+
+struct UiCall {
+    const std::function<void()>* fn;
+    bool done      = false;
+    bool abandoned = false;     // the caller gave up; fn's captures are gone
+};
+
+std::mutex              g_mu;
+std::condition_variable g_cv;
+UiPost                  g_post = nullptr;
+std::thread::id         g_ui_thread;
+bool                    g_shutdown = false;
+
+} // namespace
+
+// Awake handler: data is a heap std::shared_ptr<UiCall>.  Abandonment
+// only happens in ui_thread_shutdown() on this same thread, so the check
+// cannot race with fn().
+static void run_call(void* data) {
+    auto* holder = static_cast<std::shared_ptr<UiCall>*>(data);
+    std::shared_ptr<UiCall> call = std::move(*holder);
+    delete holder;
+    {
+        std::lock_guard<std::mutex> lk(g_mu);
+        if (call->abandoned) return;
+    }
+    (*call->fn)();
+    {
+        std::lock_guard<std::mutex> lk(g_mu);
+        call->done = true;
+    }
+    g_cv.notify_all();
+}
+
+void ui_thread_init(UiPost post) {
+    std::lock_guard<std::mutex> lk(g_mu);
+    g_post      = post;
+    g_ui_thread = std::this_thread::get_id();
+    g_shutdown  = false;
+}
+
+bool on_ui_thread() {
+    std::lock_guard<std::mutex> lk(g_mu);
+    return std::this_thread::get_id() == g_ui_thread;
+}
+
+bool run_on_ui_thread(const std::function<void()>& fn) {
+    UiPost post;
+    {
+        std::lock_guard<std::mutex> lk(g_mu);
+        if (g_shutdown) return false;
+        post = g_post;
+        if (!post || std::this_thread::get_id() == g_ui_thread) post = nullptr;
+    }
+    if (!post) { fn(); return true; }
+
+    auto call = std::make_shared<UiCall>();
+    call->fn = &fn;
+    auto* holder = new std::shared_ptr<UiCall>(call);
+    if (post(run_call, holder) != 0) {      // queue full: the handler never runs
+        delete holder;
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lk(g_mu);
+    g_cv.wait(lk, [&] { return call->done || g_shutdown; });
+    if (!call->done) call->abandoned = true;
+    return call->done;
+}
+
+// Awake handler for post_to_ui_thread(): data is a heap std::function.
+static void run_posted(void* data) {
+    std::unique_ptr<std::function<void()>> fn(static_cast<std::function<void()>*>(data));
+    {
+        std::lock_guard<std::mutex> lk(g_mu);
+        if (g_shutdown) return;
+    }
+    (*fn)();
+}
+
+bool post_to_ui_thread(std::function<void()> fn) {
+    UiPost post;
+    {
+        std::lock_guard<std::mutex> lk(g_mu);
+        if (g_shutdown) return false;
+        post = g_post;
+        if (!post || std::this_thread::get_id() == g_ui_thread) post = nullptr;
+    }
+    if (!post) { fn(); return true; }
+
+    auto* holder = new std::function<void()>(std::move(fn));
+    if (post(run_posted, holder) != 0) {
+        delete holder;
+        return false;
+    }
+    return true;
+}
+
+void ui_thread_shutdown() {
+    {
+        std::lock_guard<std::mutex> lk(g_mu);
+        g_shutdown = true;
+    }
+    g_cv.notify_all();
+}
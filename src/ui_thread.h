@@ -0,0 +1,34 @@
+#pragma once
+
+#include <functional>
+
+// Marshalling onto the UI thread.
+//
+// FLTK widgets and the graph's GraphParams belong to the thread running
+// Fl::run().  Worker threads hand work to it with run_on_ui_thread(),
+// which posts through the function given to ui_thread_init() (Fl::awake
+// in the app) and blocks until the UI thread has run it.
+
+// Posts fn(data) to the UI event loop from any thread; 0 on success.
+using UiPost = int (*)(void (*fn)(void*), void* data);
+
+// Call on the UI thread before any worker uses run_on_ui_thread().
+void ui_thread_init(UiPost post);
+
+// True on the thread that called ui_thread_init().
+bool on_ui_thread();
+
+// Run fn on the UI thread and wait for it.  Runs fn directly when called
+// on the UI thread or before ui_thread_init().  Returns false without
+// running fn once ui_thread_shutdown() has been called.
+bool run_on_ui_thread(const std::function<void()>& fn);
+
+// Queue fn on the UI thread without waiting; calls from one thread run in
+// order, interleaved in posting order with run_on_ui_thread().  Runs fn
+// directly on the UI thread or before ui_thread_init().  Returns false,
+// and fn never runs, once ui_thread_shutdown() has been called.
+bool post_to_ui_thread(std::function<void()> fn);
+
+// The UI loop has stopped: fail pending and future cross-thread calls.
+// Call on the UI thread.
+void ui_thread_shutdown();
@@ -0,0 +1,138 @@
+#include "work_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+unsigned default_thread_count() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Half-open index range owned by one thread.  The owner pops from `begin`,
+// thieves split off the upper half.
+struct WorkSlice {
+    std::mutex  mu;
+    std::size_t begin = 0;
+    std::size_t end   = 0;
+};
+
+static bool pop_front(WorkSlice& s, std::size_t& i) {
+    std::lock_guard<std::mutex> lk(s.mu);
+    if (s.begin == s.end) return false;
+    i = s.begin++;
+    return true;
+}
+
+// Move the back half of the fullest other slice into `self`.
+static bool steal(std::vector<std::unique_ptr<WorkSlice>>& slices, unsigned self) {
+    for (;;) {
+        unsigned    victim = self;
+        std::size_t best   = 0;
+        for (unsigned k = 0; k < slices.size(); ++k) {
+            if (k == self) continue;
+            std::lock_guard<std::mutex> lk(slices[k]->mu);
+            std::size_t left = slices[k]->end - slices[k]->begin;
+            if (left > best) { best = left; victim = k; }
+        }
+        if (victim == self) return false;
+
+        WorkSlice& v = *slices[victim];
+        std::size_t b, e;
+        {
+            std::lock_guard<std::mutex> lk(v.mu);
+            std::size_t left = v.end - v.begin;
+            if (left == 0) continue;               // raced with its owner: rescan
+            std::size_t take = (left + 1) / 2;
+            e = v.end;
+            b = v.end - take;
+            v.end = b;
+        }
+        std::lock_guard<std::mutex> lk(slices[self]->mu);
+        slices[self]->begin = b;
+        slices[self]->end   = e;
+        return true;
+    }
+}
+
+bool parallel_for(std::size_t n, unsigned threads,
+                  const std::function<void(std::size_t, unsigned,
+                                           const std::function<bool()>&)>& fn,
+                  const std::function<bool()>& cancelled)
+{
+    if (n == 0) return true;
+    if (threads == 0) threads = default_thread_count();
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, n));
+
+    // Only the caller (worker 0) calls `cancelled`; it raises `stop` for
+    // the rest.
+    std::atomic<bool> stop{false};
+    const std::function<bool()> caller_halted = [&] {
+        if (!stop.load(std::memory_order_relaxed) && cancelled && cancelled())
+            stop.store(true, std::memory_order_relaxed);
+        return stop.load(std::memory_order_relaxed);
+    };
+    const std::function<bool()> worker_halted = [&] {
+        return stop.load(std::memory_order_relaxed);
+    };
+
+    if (threads == 1) {
+        for (std::size_t i = 0; i < n && !caller_halted(); ++i) fn(i, 0, caller_halted);
+        return !stop.load();
+    }
+
+    std::vector<std::unique_ptr<WorkSlice>> slices;
+    for (unsigned k = 0; k < threads; ++k) {
+        slices.push_back(std::make_unique<WorkSlice>());
+        slices[k]->begin = n * k / threads;
+        slices[k]->end   = n * (k + 1) / threads;
+    }
+
+    auto work = [&](unsigned self) {
+        const std::function<bool()>& halted = self == 0 ? caller_halted : worker_halted;
+        std::size_t i;
+        for (;;) {
+            while (!halted() && pop_front(*slices[self], i)) fn(i, self, halted);
+            if (stop.load(std::memory_order_relaxed) || !steal(slices, self)) return;
+        }
+    };
+
+    std::mutex              mu;
+    std::condition_variable cv;
+    unsigned                running = threads - 1;   // guarded by mu
+    std::vector<std::thread> pool;
+    for (unsigned k = 1; k < threads; ++k) {
+        pool.emplace_back([&, k] {
+            work(k);
+            { std::lock_guard<std::mutex> lk(mu); --running; }
+            cv.notify_one();
+        });
+    }
+    work(0);
+
+    // Out of work: keep polling until the others finish their items.
+    if (cancelled) {
+        std::unique_lock<std::mutex> lk(mu);
+        while (!cv.wait_for(lk, kCancelPollInterval, [&] { return running == 0; })) {
+            lk.unlock();
+            caller_halted();
+            lk.lock();
+        }
+    }
+    for (auto& t : pool) t.join();
+    return !stop.load();
+}
+
+bool parallel_for(std::size_t n, unsigned threads,
+                  const std::function<void(std::size_t, unsigned)>& fn,
+                  const std::function<bool()>& cancelled)
+{
+    return parallel_for(n, threads,
+                        [&fn](std::size_t i, unsigned worker, const std::function<bool()>&) {
+                            fn(i, worker);
+                        },
+                        cancelled);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+// Runs fn(i, worker, halted) for every i in [0, n) on `threads` threads
+// (0 = one per hardware thread) and returns when all are done.  `worker` is
+// the index of the calling thread in [0, threads), for per-thread scratch
+// space; long items may poll `halted` to stop early.
+//
+// Work stealing: each thread starts with a contiguous slice of [0, n) and
+// takes items from its front; a thread that runs dry steals the back half
+// of the fullest remaining slice.  Uneven item costs (e.g. sweep points
+// with very different sample counts) therefore still keep every core busy.
+// fn must not throw.
+//
+// `cancelled` is only ever called on the calling thread (worker 0), so it
+// may read thread-affine state (e.g. Tcl_Canceled on the interp's thread).
+// That thread polls it before each item it runs, through `halted` inside
+// its items, and every kCancelPollInterval while it waits for the other
+// workers.  Once it fires every worker sees `halted` return true, stops
+// after (or, if it checks `halted`, during) its current item, and
+// parallel_for returns false.
+static constexpr std::chrono::milliseconds kCancelPollInterval{1};
+
+bool parallel_for(std::size_t n, unsigned threads,
+                  const std::function<void(std::size_t i, unsigned worker,
+                                           const std::function<bool()>& halted)>& fn,
+                  const std::function<bool()>& cancelled = {});
+
+// The same for items too short to need `halted`.
+bool parallel_for(std::size_t n, unsigned threads,
+                  const std::function<void(std::size_t i, unsigned worker)>& fn,
+                  const std::function<bool()>& cancelled = {});
+
+// Thread count parallel_for() uses for `threads` == 0.
+unsigned default_thread_count();
@@ -0,0 +1,128 @@
+// Call-overhead benchmark for the Python bindings.
+// The same graph_get/graph_set/graph_eval bodies registered once with
+// METH_VARARGS + PyArg_ParseTuple (the old binding style) and once with
+// METH_FASTCALL + py_args.h (the current one), on a local GraphParams.
+// Prints ns per call; not part of ctest.
+
+#include <Python.h>   // Must come first on some platforms.
+
+#include "graph_params.h"
+#include "py_args.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static GraphParams g_bench_params;
+
+static PyObject* bench_get_varargs(PyObject*, PyObject* args) {
+    const char* param;
+    if (!PyArg_ParseTuple(args, "s", &param)) return nullptr;
+    return PyFloat_FromDouble(g_bench_params.get(param));
+}
+
+static PyObject* bench_set_varargs(PyObject*, PyObject* args) {
+    const char* param; double value;
+    if (!PyArg_ParseTuple(args, "sd", &param, &value)) return nullptr;
+    g_bench_params.set(param, value);
+    Py_RETURN_NONE;
+}
+
+static PyObject* bench_eval_varargs(PyObject*, PyObject* args) {
+    double t;
+    if (!PyArg_ParseTuple(args, "d", &t)) return nullptr;
+    auto [x, y] = g_bench_params.eval(t);
+    return Py_BuildValue("(dd)", x, y);
+}
+
+static PyObject* bench_get_fastcall(PyObject*, PyObject* const* args, Py_ssize_t nargs) {
+    const char* param;
+    if (!py_nargs("get", nargs, 1, 1) || !py_arg_str(args[0], param)) return nullptr;
+    return PyFloat_FromDouble(g_bench_params.get(param));
+}
+
+static PyObject* bench_set_fastcall(PyObject*, PyObject* const* args, Py_ssize_t nargs) {
+    const char* param; double value;
+    if (!py_nargs("set", nargs, 2, 2) ||
+        !py_arg_str(args[0], param) || !py_arg_double(args[1], value)) return nullptr;
+    g_bench_params.set(param, value);
+    Py_RETURN_NONE;
+}
+
+static PyObject* bench_eval_fastcall(PyObject*, PyObject* const* args, Py_ssize_t nargs) {
+    double t;
+    if (!py_nargs("eval", nargs, 1, 1) || !py_arg_double(args[0], t)) return nullptr;
+    auto [x, y] = g_bench_params.eval(t);
+    PyObject* xy = PyTuple_New(2);
+    if (!xy) return nullptr;
+    PyTuple_SET_ITEM(xy, 0, PyFloat_FromDouble(x));
+    PyTuple_SET_ITEM(xy, 1, PyFloat_FromDouble(y));
+    return xy;
+}
+
+static PyMethodDef bench_varargs_defs[] = {
+    {"get",  bench_get_varargs,  METH_VARARGS, nullptr},
+    {"set",  bench_set_varargs,  METH_VARARGS, nullptr},
+    {"eval", bench_eval_varargs, METH_VARARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyMethodDef bench_fastcall_defs[] = {
+    {"get",  PY_CFUNC(bench_get_fastcall),  METH_FASTCALL, nullptr},
+    {"set",  PY_CFUNC(bench_set_fastcall),  METH_FASTCALL, nullptr},
+    {"eval", PY_CFUNC(bench_eval_fastcall), METH_FASTCALL, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+// Run `body` `iters` times in a namespace holding `defs`; ns per iteration.
+static double py_bench(PyMethodDef* defs, const char* body, long iters) {
+    PyObject* ns = PyDict_New();
+    PyDict_SetItemString(ns, "__builtins__", PyEval_GetBuiltins());
+    for (PyMethodDef* m = defs; m->ml_name; ++m) {
+        PyObject* f = PyCFunction_New(m, nullptr);
+        PyDict_SetItemString(ns, m->ml_name, f);
+        Py_DECREF(f);
+    }
+    std::string code = "def _bench(n):\n    for i in range(n):\n        " + std::string(body) + "\n";
+    PyObject* r = PyRun_String(code.c_str(), Py_file_input, ns, ns);
+    Py_XDECREF(r);
+    PyObject* fn = PyDict_GetItemString(ns, "_bench");
+    double ns_per = -1.0;
+    if (fn) {
+        auto t0 = std::chrono::steady_clock::now();
+        PyObject* out = PyObject_CallFunction(fn, "l", iters);
+        auto t1 = std::chrono::steady_clock::now();
+        if (out) ns_per = std::chrono::duration<double, std::nano>(t1 - t0).count() / iters;
+        Py_XDECREF(out);
+    }
+    if (PyErr_Occurred()) PyErr_Print();
+    Py_DECREF(ns);
+    return ns_per;
+}
+
+int main(int argc, char** argv) {
+    long iters = argc > 1 ? std::atol(argv[1]) : 200000;
+    if (iters <= 0) {
+        std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+    struct Case { const char* name; const char* body; };
+    const Case cases[] = {
+        {"graph_get",  "get('a')"},
+        {"graph_set",  "set('delta', 0.5)"},
+        {"graph_eval", "eval(0.25)"},
+    };
+
+    Py_Initialize();
+    int rc = 0;
+    for (const Case& c : cases) {
+        double slow = py_bench(bench_varargs_defs, c.body, iters);
+        double fast = py_bench(bench_fastcall_defs, c.body, iters);
+        if (slow <= 0.0 || fast <= 0.0) rc = 1;
+        std::printf("%-10s METH_VARARGS %6.1f ns/call   METH_FASTCALL %6.1f ns/call\n",
+                    c.name, slow, fast);
+    }
+    Py_FinalizeEx();
+    return rc;
+}
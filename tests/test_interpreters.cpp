@@ -6,13 +6,43 @@
 
 #include <tcl.h>
 
+#include "adaptive_sampler.h"
+#include "curve_buffer.h"
+#include "curve_projection.h"
+#include "curve_stream.h"
+#include "curve_worker.h"
+#include "fltkgraph_module.h"
+#include "frame_scheduler.h"
 #include "graph_params.h"
-
+#include "graph_raster.h"
+#include "output_stage.h"
+#include "param_sweep.h"
+#include "polyline_decimator.h"
+#include "py_executor.h"
+#include "py_writer.h"
+#include "scrollback.h"
+#include "sine_kernel.h"
+#include "tcl_executor.h"
+#include "tcl_graph_cmd.h"
+#include "tcl_param_link.h"
+#include "tcl_script_cache.h"
+#include "ui_thread.h"
+#include "work_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
+#include <deque>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 // ── Tiny test harness ───────────────────────────────────────────
@@ -107,21 +137,8 @@ static int test_puts_cmd(ClientData /*cd*/, Tcl_Interp* interp,
 }
 
 // ── Python helpers ──────────────────────────────────────────────
-static std::string py_drain_stringio(PyObject* sio) {
-    std::string result;
-    PyObject* val = PyObject_CallMethod(sio, "getvalue", nullptr);
-    if (val) {
-        const char* s = PyUnicode_AsUTF8(val);
-        if (s) result = s;
-        Py_DECREF(val);
-    }
-    PyObject* zero = PyLong_FromLong(0);
-    PyObject* r1 = PyObject_CallMethod(sio, "truncate", "O", zero);
-    Py_XDECREF(r1);
-    PyObject* r2 = PyObject_CallMethod(sio, "seek", "O", zero);
-    Py_XDECREF(r2);
-    Py_DECREF(zero);
-    return result;
+static std::string py_drain(PyObject* writer) {
+    return console_writer_take(writer);
 }
 
 struct PushResult {
@@ -136,20 +153,80 @@ static PushResult py_push(PyObject* console,
 {
     PushResult pr{};
     PyObject* r = PyObject_CallMethod(console, "push", "s", line);
-    pr.out = py_drain_stringio(cap_out);
-    pr.err = py_drain_stringio(cap_err);
+    pr.out = py_drain(cap_out);
+    pr.err = py_drain(cap_err);
     if (r) {
         pr.more = PyObject_IsTrue(r);
         Py_DECREF(r);
     } else {
         PyErr_Print();
-        pr.out += py_drain_stringio(cap_out);
-        pr.err += py_drain_stringio(cap_err);
+        pr.out += py_drain(cap_out);
+        pr.err += py_drain(cap_err);
         pr.more = false;
     }
     return pr;
 }
 
+// ── Fake graph handle ───────────────────────────────────────────
+// Stands in for the graph window behind the Tcl `graph` command and the
+// fltkgraph module: a plain GraphParams plus call counters.
+static GraphParams g_fg_params;
+static bool        g_fg_window   = true;
+static int         g_fg_changed  = 0;
+static int         g_fg_launched = 0;
+
+static GraphParams* fg_params()  { return g_fg_window ? &g_fg_params : nullptr; }
+static void fg_changed(bool)     { ++g_fg_changed; }
+static void fg_launch(bool tk)   { g_fg_launched += tk ? 1 : 10; }
+static FrameStats fg_frame_stats() {
+    FrameStats st;
+    st.frames = 7;
+    return st;
+}
+
+static const GraphHandle kFakeGraph{fg_params, fg_changed, fg_frame_stats, fg_launch};
+
+static int test_graph_cmd(ClientData cd, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    return graph_command(*static_cast<const GraphHandle*>(cd), interp, objc, objv);
+}
+
+// The doubles of a Tcl list result.
+static std::vector<double> tcl_doubles(Tcl_Interp* interp) {
+    std::vector<double> out;
+    Tcl_Size n;
+    Tcl_Obj** elems;
+    if (Tcl_ListObjGetElements(interp, Tcl_GetObjResult(interp), &n, &elems) != TCL_OK)
+        return out;
+    for (Tcl_Size i = 0; i < n; ++i) {
+        double v = 0.0;
+        Tcl_GetDoubleFromObj(nullptr, elems[i], &v);
+        out.push_back(v);
+    }
+    return out;
+}
+
+// str() of `expr` in a fresh namespace that has imported fltkgraph, or
+// the text of the exception it raised.
+static std::string fg_eval(const char* expr) {
+    PyObject* ns = PyDict_New();
+    PyDict_SetItemString(ns, "__builtins__", PyEval_GetBuiltins());
+    PyObject* r = PyRun_String("from fltkgraph import *\nimport fltkgraph\n",
+                               Py_file_input, ns, ns);
+    if (r) Py_SETREF(r, PyRun_String(expr, Py_eval_input, ns, ns));
+    if (r) {
+        Py_SETREF(r, PyObject_Str(r));
+    } else {
+        PyObject *type, *value, *tb;
+        PyErr_Fetch(&type, &value, &tb);
+        r = PyObject_Str(value ? value : type);
+        Py_XDECREF(type); Py_XDECREF(value); Py_XDECREF(tb);
+    }
+    std::string out = r ? PyUnicode_AsUTF8(r) : "";
+    Py_XDECREF(r);
+    Py_DECREF(ns);
+    return out;
+}
+
 // ═════════════════════════════════════════════════════════════════
 //  Tcl tests
 // ═════════════════════════════════════════════════════════════════
@@ -228,6 +305,221 @@ static void run_tcl_tests() {
         CHECK_STR(Tcl_GetStringResult(interp), "4");
     });
 
+    run_test("tcl_script_cache_keeps_bytecode", [&]() {
+        TclScriptCache cache(2);
+        Tcl_Obj* a = cache.acquire("set y [expr {1 + 2}]");
+        CHECK(Tcl_EvalObjEx(interp, a, TCL_EVAL_GLOBAL) == TCL_OK);
+        CHECK(a->typePtr && std::strcmp(a->typePtr->name, "bytecode") == 0);
+        Tcl_DecrRefCount(a);
+        Tcl_Obj* again = cache.acquire("set y [expr {1 + 2}]");
+        CHECK(again == a);                      // same object, bytecode intact
+        CHECK(std::strcmp(again->typePtr->name, "bytecode") == 0);
+        Tcl_DecrRefCount(again);
+
+        Tcl_DecrRefCount(cache.acquire("set z 1"));
+        Tcl_DecrRefCount(cache.acquire("set z 2"));   // evicts the oldest
+        ScriptCacheStats st = cache.stats();
+        CHECK(st.hits == 1 && st.misses == 3 && st.size == 2 && st.capacity == 2);
+        Tcl_DecrRefCount(cache.acquire("set y [expr {1 + 2}]"));
+        CHECK(cache.stats().misses == 4);
+
+        std::string big(TclScriptCache::kMaxScriptBytes + 1, ' ');
+        Tcl_Obj* b = cache.acquire(big);
+        CHECK(Tcl_EvalObjEx(interp, b, TCL_EVAL_GLOBAL) == TCL_OK);
+        Tcl_DecrRefCount(b);
+        CHECK(cache.stats().size == 2);         // bypassed
+        cache.clear();
+        CHECK(cache.stats().size == 0);
+    });
+
+    run_test("tcl_param_link", [&]() {
+        GraphParams live;
+        live.a = 4.0;
+        int pulls = 0, pushes = 0;
+        unsigned pushed_mask = 0;
+        TclParamLink link({
+            [&](GraphParams& out) { ++pulls; out = live; return true; },
+            [&](const GraphParams& v, unsigned dirty) {
+                ++pushes;
+                pushed_mask |= dirty;
+                for (const ParamDesc& d : kParamDescs)
+                    if (dirty & (1u << static_cast<unsigned>(d.id))) live.set(d.id, v.get(d.id));
+            },
+        });
+        Tcl_Interp* li = Tcl_CreateInterp();
+        CHECK(link.attach(li) == TCL_OK);
+
+        // The first read pulls; later reads in the interval use the shadow.
+        CHECK(Tcl_Eval(li, "list $graph_params(a) $graph_params(b) $graph_params(points)") == TCL_OK);
+        CHECK_STR(Tcl_GetStringResult(li), "4.0 2.0 1000");
+        CHECK(pulls == 1);
+
+        // A write loop is coalesced: the final value arrives on flush().
+        CHECK(Tcl_Eval(li, "for {set i 1} {$i <= 5000} {incr i} "
+                           "{set graph_params(delta) [expr {$i * 0.001}]}") == TCL_OK);
+        link.flush();
+        CHECK(pushes >= 1 && pushes < 50);
+        CHECK(pushed_mask == 1u << static_cast<unsigned>(ParamId::delta));
+        CHECK_NEAR(live.delta, 5.0, 1e-12);
+
+        // Rejected values leave the shadow and the dirty set alone.
+        int before = pushes;
+        CHECK(Tcl_Eval(li, "set graph_params(points) 1.5") == TCL_ERROR);
+        CHECK(Tcl_Eval(li, "set graph_params(points) 2000") == TCL_OK);
+        link.flush();
+        CHECK(live.num_points == 2000);
+        CHECK(pushes <= before + 1);
+
+        // Out-of-range points are clamped like `graph set`, and the next
+        // read shows the clamped value.
+        CHECK(Tcl_Eval(li, "set graph_params(points) 0") == TCL_OK);
+        CHECK(Tcl_Eval(li, "set graph_params(points)") == TCL_OK);
+        CHECK_STR(Tcl_GetStringResult(li), "1");
+        CHECK(live.num_points == 1);
+        CHECK(Tcl_Eval(li, "set graph_params(points) 2000000000; set graph_params(points)") == TCL_OK);
+        CHECK_STR(Tcl_GetStringResult(li), std::to_string(GraphParams::kMaxPoints));
+        CHECK(live.num_points == GraphParams::kMaxPoints);
+
+        // After invalidate() the next read sees changes made elsewhere.
+        live.b = 7.0;
+        link.invalidate();
+        CHECK(Tcl_Eval(li, "set graph_params(b)") == TCL_OK);
+        CHECK_STR(Tcl_GetStringResult(li), "7.0");
+
+        // Other elements of the array are plain variables.
+        CHECK(Tcl_Eval(li, "set graph_params(note) hi") == TCL_OK);
+        Tcl_DeleteInterp(li);
+    });
+
+    Tcl_CreateObjCommand(interp, "graph", test_graph_cmd,
+                         const_cast<GraphHandle*>(&kFakeGraph), nullptr);
+
+    run_test("tcl_graph_words_exact", [&]() {
+        CHECK(Tcl_Eval(interp, "graph se delta 1") == TCL_ERROR);
+        CHECK_CONTAINS(Tcl_GetStringResult(interp), "bad subcommand \"se\": must be set, get,");
+        CHECK(Tcl_Eval(interp, "graph get del") == TCL_ERROR);
+        CHECK_CONTAINS(Tcl_GetStringResult(interp), "bad parameter \"del\"");
+        CHECK(Tcl_Eval(interp, "graph sweep -thr 2") == TCL_ERROR);
+        CHECK_CONTAINS(Tcl_GetStringResult(interp), "bad option \"-thr\": must be -a, -b,");
+        CHECK(Tcl_Eval(interp, "graph set delta 1; graph get delta") == TCL_OK);
+        CHECK_STR(Tcl_GetStringResult(interp), "1.0");
+    });
+
+    run_test("tcl_graph_eval_args", [&]() {
+        const char* usage = "usage: graph eval <t> | graph eval ?-bytes? -list {t ...} | "
+                            "graph eval ?-bytes? -range <t0> <t1> <n>";
+        const char* bad[] = {
+            "graph eval", "graph eval 1 2", "graph eval -bytes 1.0", "graph eval -bytes -list",
+            "graph eval -list {1 2} 3", "graph eval -range 0 1", "graph eval -range 0 1 2 3",
+            "graph eval -bytes -bytes -list {1}", "graph eval -values {1}",
+        };
+        for (const char* script : bad) {
+            CHECK(Tcl_Eval(interp, script) == TCL_ERROR);
+            CHECK_STR(Tcl_GetStringResult(interp), usage);
+        }
+        // A lone word is always the scalar form's t.
+        CHECK(Tcl_Eval(interp, "graph eval -list") == TCL_ERROR);
+        CHECK_STR(Tcl_GetStringResult(interp), "expected floating-point number but got \"-list\"");
+        CHECK(Tcl_Eval(interp, "graph eval -list {0.5 x}") == TCL_ERROR);
+        CHECK_CONTAINS(Tcl_GetStringResult(interp), "expected floating-point number");
+        CHECK(Tcl_Eval(interp, "graph eval -list \"a {b\"") == TCL_ERROR);
+        CHECK_CONTAINS(Tcl_GetStringResult(interp), "unmatched open brace");
+        CHECK(Tcl_Eval(interp, "graph eval -range 0 1 1.5") == TCL_ERROR);
+        CHECK_CONTAINS(Tcl_GetStringResult(interp), "expected integer");
+
+        // n bounds of the -range form.
+        CHECK(Tcl_Eval(interp, "graph eval -range 0 1 -1") == TCL_ERROR);
+        CHECK_STR(Tcl_GetStringResult(interp), "sample count must be between 0 and 10000000");
+        CHECK(Tcl_Eval(interp, "graph eval -range 0 1 10000001") == TCL_ERROR);
+        CHECK_STR(Tcl_GetStringResult(interp), "sample count must be between 0 and 10000000");
+        CHECK(Tcl_Eval(interp, "graph eval -range 0 1 0") == TCL_OK);
+        CHECK_STR(Tcl_GetStringResult(interp), "");
+        CHECK(Tcl_Eval(interp, "string length [graph eval -bytes -range 0 1 0]") == TCL_OK);
+        CHECK_STR(Tcl_GetStringResult(interp), "0");
+        CHECK(Tcl_Eval(interp, "graph eval -list {}") == TCL_OK);
+        CHECK_STR(Tcl_GetStringResult(interp), "");
+
+        g_fg_window = false;
+        CHECK(Tcl_Eval(interp, "graph eval -range 0 1 4") == TCL_ERROR);
+        CHECK_STR(Tcl_GetStringResult(interp), "graph window not available");
+        g_fg_window = true;
+    });
+
+    // Ctrl+C in the console is TclExecutor::cancel(): Tcl_CancelEval from
+    // the UI thread.  A long sweep must notice it and unwind.
+    run_test("tcl_graph_sweep_cancel", [&]() {
+        Tcl_Interp* ci = Tcl_CreateInterp();
+        Tcl_CreateObjCommand(ci, "graph", test_graph_cmd,
+                             const_cast<GraphHandle*>(&kFakeGraph), nullptr);
+        std::thread canceller([ci] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            Tcl_CancelEval(ci, nullptr, nullptr, TCL_CANCEL_UNWIND);
+        });
+        auto t0 = std::chrono::steady_clock::now();
+        int rc = Tcl_Eval(ci, "graph sweep -delta {0 1 100000} -points 1000000 -threads 2");
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        canceller.join();
+        CHECK(rc == TCL_ERROR);
+        CHECK_STR(Tcl_GetStringResult(ci), "eval unwound");
+        CHECK(secs < 5.0);
+        Tcl_DeleteInterp(ci);
+    });
+
+    run_test("tcl_graph_eval_results", [&]() {
+        g_fg_params = GraphParams{};
+        g_fg_params.delta = 0.7;
+        const GraphParams& p = g_fg_params;
+
+        // -list agrees with eval_many, -range with eval_range, as x0 y0 x1 y1 ...
+        const double ts[] = {0.0, 0.5, 1.25, -3.0, 100.0};
+        double xs[5], ys[5];
+        p.eval_many(ts, 5, xs, ys);
+        CHECK(Tcl_Eval(interp, "graph eval -list {0.0 0.5 1.25 -3 100}") == TCL_OK);
+        std::vector<double> got = tcl_doubles(interp);
+        CHECK(got.size() == 10);
+        for (int i = 0; i < 5; ++i) {
+            CHECK(got[2 * i] == xs[i]);
+            CHECK(got[2 * i + 1] == ys[i]);
+        }
+
+        const std::size_t n = 257;
+        std::vector<double> rx(n), ry(n);
+        p.eval_range(-1.0, 2.0, n, rx.data(), ry.data());
+        CHECK(Tcl_Eval(interp, "graph eval -range -1 2 257") == TCL_OK);
+        got = tcl_doubles(interp);
+        CHECK(got.size() == 2 * n);
+        for (std::size_t i = 0; i < n; ++i) {
+            CHECK(got[2 * i] == rx[i]);
+            CHECK(got[2 * i + 1] == ry[i]);
+        }
+
+        // -bytes packs the same values as native doubles, same layout.
+        CHECK(Tcl_Eval(interp, "graph eval -bytes -range -1 2 257") == TCL_OK);
+        Tcl_Size len;
+        const unsigned char* raw = Tcl_GetByteArrayFromObj(Tcl_GetObjResult(interp), &len);
+        CHECK(len == static_cast<Tcl_Size>(2 * n * sizeof(double)));
+        for (std::size_t i = 0; i < n; ++i) {
+            double xy[2];
+            std::memcpy(xy, raw + 2 * i * sizeof(double), sizeof xy);
+            CHECK(xy[0] == rx[i] && xy[1] == ry[i]);
+        }
+        CHECK(Tcl_Eval(interp, "graph eval -bytes -list {0.0 0.5 1.25 -3 100}") == TCL_OK);
+        raw = Tcl_GetByteArrayFromObj(Tcl_GetObjResult(interp), &len);
+        CHECK(len == static_cast<Tcl_Size>(10 * sizeof(double)));
+        for (int i = 0; i < 5; ++i) {
+            double xy[2];
+            std::memcpy(xy, raw + 2 * i * sizeof(double), sizeof xy);
+            CHECK(xy[0] == xs[i] && xy[1] == ys[i]);
+        }
+
+        // The scalar form matches eval() to the bulk kernels' ~1e-13.
+        CHECK(Tcl_Eval(interp, "graph eval 1.25") == TCL_OK);
+        got = tcl_doubles(interp);
+        auto [x, y] = p.eval(1.25);
+        CHECK(got.size() == 2 && got[0] == x && got[1] == y);
+        CHECK(std::fabs(got[0] - xs[2]) < 1e-12 && std::fabs(got[1] - ys[2]) < 1e-12);
+    });
+
     Tcl_DeleteInterp(interp);
 }
 
@@ -237,9 +529,10 @@ static void run_tcl_tests() {
 static void run_python_tests() {
     std::cout << "\n=== Python interpreter tests ===\n";
 
+    fltkgraph_register(kFakeGraph);
     Py_Initialize();
 
-    // Set up InteractiveConsole + StringIO capture (same as the app).
+    // Set up InteractiveConsole + native writer capture (same as the app).
     PyObject* locals = PyDict_New();
     PyObject* code_mod = PyImport_ImportModule("code");
     PyObject* ic_class = PyObject_GetAttrString(code_mod, "InteractiveConsole");
@@ -250,13 +543,8 @@ static void run_python_tests() {
     Py_DECREF(args);
     Py_DECREF(ic_class);
 
-    PyObject* io_mod = PyImport_ImportModule("io");
-    PyObject* sio_class = PyObject_GetAttrString(io_mod, "StringIO");
-    Py_DECREF(io_mod);
-
-    PyObject* cap_out = PyObject_CallNoArgs(sio_class);
-    PyObject* cap_err = PyObject_CallNoArgs(sio_class);
-    Py_DECREF(sio_class);
+    PyObject* cap_out = console_writer_new();
+    PyObject* cap_err = console_writer_new();
 
     PyObject* sys_mod = PyImport_ImportModule("sys");
     PyObject_SetAttrString(sys_mod, "stdout", cap_out);
@@ -353,11 +641,415 @@ static void run_python_tests() {
         CHECK_CONTAINS(r.out, "recovered");
     });
 
+    run_test("py_console_writer", [&]() {
+        auto r = py_push(console, cap_out, cap_err,
+                         "for i in range(10000): print('line', i)");
+        r = py_push(console, cap_out, cap_err, "");
+        CHECK(std::count(r.out.begin(), r.out.end(), '\n') == 10000);
+        CHECK(r.out.rfind("line 9999\n") == r.out.size() - 10);
+        r = py_push(console, cap_out, cap_err, "import sys; print(sys.stdout.encoding, sys.stdout.isatty())");
+        CHECK_STR(r.out.c_str(), "utf-8 False\n");
+        r = py_push(console, cap_out, cap_err, "print('\u00e9t\u00e9', end='')");
+        CHECK_STR(r.out.c_str(), "\xc3\xa9t\xc3\xa9");
+        r = py_push(console, cap_out, cap_err, "n = sys.stdout.write(b'x')");
+        CHECK_CONTAINS(r.err, "must be str");
+        r = py_push(console, cap_out, cap_err, "type(sys.stdout)()");
+        CHECK_CONTAINS(r.err, "TypeError");
+
+        int notified = 0;
+        PyObject* w = console_writer_new([](void* n) { ++*static_cast<int*>(n); }, &notified);
+        PyObject* res = PyObject_CallMethod(w, "write", "s", "a");
+        Py_XDECREF(res);
+        res = PyObject_CallMethod(w, "write", "s", "b");
+        Py_XDECREF(res);
+        CHECK(notified == 1);                   // once per batch
+        CHECK_STR(console_writer_take(w).c_str(), "ab");
+        res = PyObject_CallMethod(w, "write", "s", "c");
+        Py_XDECREF(res);
+        CHECK(notified == 2);
+        Py_DECREF(w);
+        CHECK(console_writer_take(locals).empty());
+    });
+
+    run_test("py_fltkgraph_arguments", [&]() {
+        g_fg_params = GraphParams{};
+        CHECK_STR(fg_eval("graph_get()").c_str(),
+                  "graph_get() takes exactly 1 argument (0 given)");
+        CHECK_STR(fg_eval("graph_set('a')").c_str(),
+                  "graph_set() takes exactly 2 arguments (1 given)");
+        CHECK_STR(fg_eval("graph_eval_many(1, 0, 1, 2)").c_str(),
+                  "graph_eval_many() takes from 1 to 3 arguments (4 given)");
+        CHECK_STR(fg_eval("graph_get(1)").c_str(), "expected str, got int");
+        CHECK_STR(fg_eval("graph_eval('x')").c_str(), "must be real number, not str");
+        CHECK_STR(fg_eval("graph_render('x.ppm', 1.5, 2)").c_str(),
+                  "'float' object cannot be interpreted as an integer");
+
+        // Ints, floats and __float__ objects are all accepted as numbers.
+        CHECK_STR(fg_eval("graph_eval(1.0) == graph_eval(1)").c_str(), "True");
+        CHECK_STR(fg_eval("graph_eval(__import__('fractions').Fraction(1, 2)) == graph_eval(0.5)")
+                      .c_str(), "True");
+        CHECK_STR(fg_eval("graph_eval(0.25) == (graph_get('A') * __import__('math').sin("
+                          "graph_get('a') * 0.25 + graph_get('delta')), "
+                          "graph_get('B') * __import__('math').sin(graph_get('b') * 0.25))")
+                      .c_str(), "True");
+        CHECK_STR(fg_eval("graph_set('b', 5)").c_str(), "None");
+        CHECK_STR(fg_eval("graph_params()['b']").c_str(), "5.0");
+    });
+
+    run_test("py_fltkgraph_module", [&]() {
+        g_fg_changed = 0;
+        CHECK_STR(fg_eval("type(fltkgraph._graph).__name__").c_str(), "PyCapsule");
+        CHECK_STR(fg_eval("graph_set('delta', 0.5)").c_str(), "None");
+        CHECK(g_fg_params.delta == 0.5);
+        CHECK(g_fg_changed == 1);
+        CHECK_STR(fg_eval("graph_get('delta')").c_str(), "0.5");
+        CHECK_STR(fg_eval("graph_stats()['frames']").c_str(), "7");
+        CHECK_STR(fg_eval("launch_tk_plugin()").c_str(), "None");
+        CHECK_STR(fg_eval("launch_tkinter_plugin()").c_str(), "None");
+        CHECK(g_fg_launched == 11);
+
+        // Names resolve through the descriptor table; set() clamps.
+        CHECK_STR(fg_eval("graph_get('x')").c_str(),
+                  "unknown parameter (a, b, delta, A, B, points)");
+        CHECK_STR(fg_eval("graph_set('points', 0)").c_str(), "None");
+        CHECK(g_fg_params.num_points == 1);
+        CHECK_STR(fg_eval("graph_get('points')").c_str(), "1.0");
+
+        g_fg_window = false;
+        CHECK_STR(fg_eval("graph_get('a')").c_str(), "graph window not available");
+        CHECK_STR(fg_eval("graph_stats()").c_str(), "graph window not available");
+        g_fg_window = true;
+    });
+
+    run_test("py_graph_eval_buffers", [&]() {
+        // eval_interleaved crosses its 4096-point chunks seamlessly.
+        GraphParams p;
+        p.delta = 0.3;
+        const std::size_t n = 9000;
+        std::vector<double> out(2 * n);
+        eval_interleaved(p, 0.0, 2.0 * M_PI, n, out.data());
+        double worst = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            auto [x, y] = p.eval(2.0 * M_PI * double(i) / double(n - 1));
+            worst = std::max({worst, std::fabs(out[2 * i] - x), std::fabs(out[2 * i + 1] - y)});
+        }
+        CHECK(worst < 1e-12);
+
+        g_fg_params = GraphParams{};
+        CHECK_STR(fg_eval("len(graph_eval_many(5))").c_str(), "10");
+        CHECK_STR(fg_eval("graph_eval_many(5).format").c_str(), "d");
+        CHECK_STR(fg_eval("(lambda m: all(abs(m[2*i] - graph_eval(i * 0.25)[0]) < 1e-12 and "
+                          "abs(m[2*i+1] - graph_eval(i * 0.25)[1]) < 1e-12 for i in range(5)))"
+                          "(graph_eval_many(5, 0.0, 1.0))").c_str(), "True");
+        CHECK_STR(fg_eval("len(graph_eval_many(0))").c_str(), "0");
+        CHECK_CONTAINS(fg_eval("graph_eval_many(-1)"), "n must be between 0 and");
+        CHECK_CONTAINS(fg_eval("graph_eval_many(10**8)"), "n must be between 0 and");
+        CHECK_CONTAINS(fg_eval("graph_eval_many()"), "takes");
+
+        // graph_eval_into: doubles only, writable, 2 doubles per point.
+        CHECK_STR(fg_eval("(lambda b: (graph_eval_into(b, 0.0, 1.0), "
+                          "list(b) == list(graph_eval_many(3, 0.0, 1.0)))"
+                          ")(__import__('array').array('d', [0.0] * 6))").c_str(),
+                  "(3, True)");
+        CHECK_STR(fg_eval("(lambda b: (graph_eval_into(b), b[4]))"
+                          "(__import__('array').array('d', [0.0, 0.0, 0.0, 0.0, -7.0]))").c_str(),
+                  "(2, -7.0)");
+        CHECK_STR(fg_eval("graph_eval_into(__import__('array').array('f', [0.0] * 4))").c_str(),
+                  "buffer must hold doubles (format 'd')");
+        CHECK_STR(fg_eval("graph_eval_into(bytearray(32))").c_str(),
+                  "buffer must hold doubles (format 'd')");
+        CHECK_CONTAINS(fg_eval("graph_eval_into(bytes(32))"), "writable");
+        CHECK_CONTAINS(fg_eval("graph_eval_into(memoryview(__import__('array').array('d', [0.0] * 4))"
+                               ".toreadonly())"), "writable");
+    });
+
     Py_DECREF(console);
     Py_DECREF(cap_out);
     Py_DECREF(cap_err);
     Py_DECREF(locals);
     Py_FinalizeEx();
+
+    // The inittab entry and handle outlive the interpreter.
+    run_test("py_fltkgraph_reinit", [&]() {
+        Py_Initialize();
+        g_fg_params.a = 4.0;
+        CHECK_STR(fg_eval("graph_get('a')").c_str(), "4.0");
+        CHECK_STR(fg_eval("type(fltkgraph._graph).__name__").c_str(), "PyCapsule");
+        Py_FinalizeEx();
+    });
+}
+
+// ═════════════════════════════════════════════════════════════════
+//  Threaded interpreter tests (PyExecutor owns Python on its own thread)
+// ═════════════════════════════════════════════════════════════════
+
+// Stand-in for the FLTK awake queue: posted handlers run when pumped.
+static std::mutex                                       g_ui_mu;
+static std::deque<std::pair<void (*)(void*), void*>>    g_ui_queue;
+
+static int fake_post(void (*fn)(void*), void* data) {
+    std::lock_guard<std::mutex> lk(g_ui_mu);
+    g_ui_queue.emplace_back(fn, data);
+    return 0;
+}
+
+static void fake_pump() {
+    for (;;) {
+        std::pair<void (*)(void*), void*> item;
+        {
+            std::lock_guard<std::mutex> lk(g_ui_mu);
+            if (g_ui_queue.empty()) return;
+            item = g_ui_queue.front();
+            g_ui_queue.pop_front();
+        }
+        item.first(item.second);
+    }
+}
+
+// Counts finished commands and remembers the last "more" flag.
+struct ExecWatch {
+    std::mutex              mu;
+    std::condition_variable cv;
+    int                     done = 0;
+    bool                    more = false;
+
+    void on_done(bool m) {
+        { std::lock_guard<std::mutex> lk(mu); ++done; more = m; }
+        cv.notify_all();
+    }
+    bool wait_for(int n) {
+        std::unique_lock<std::mutex> lk(mu);
+        return cv.wait_for(lk, std::chrono::seconds(10), [&] { return done >= n; });
+    }
+};
+
+static void run_executor_tests() {
+    std::cout << "\n=== Threaded interpreter tests ===\n";
+
+    run_test("ui_thread_marshal", [&]() {
+        ui_thread_init(fake_post);
+        CHECK(on_ui_thread());
+        int ran_on_ui = 0;
+        CHECK(run_on_ui_thread([&] { ran_on_ui += on_ui_thread(); }));   // inline
+        CHECK(ran_on_ui == 1);
+
+        std::atomic<bool> ok{false}, finished{false};
+        std::thread worker([&] {
+            ok = run_on_ui_thread([&] { ran_on_ui += on_ui_thread(); });
+            finished = true;
+        });
+        while (!finished) { fake_pump(); std::this_thread::yield(); }
+        worker.join();
+        CHECK(ok);
+        CHECK(ran_on_ui == 2);
+
+        // A caller still waiting when the UI loop stops gets false and its
+        // posted call is dropped.
+        std::thread late([&] { ok = run_on_ui_thread([&] { ++ran_on_ui; }); });
+        while (true) {
+            std::lock_guard<std::mutex> lk(g_ui_mu);
+            if (!g_ui_queue.empty()) break;
+        }
+        ui_thread_shutdown();
+        late.join();
+        fake_pump();
+        CHECK(!ok);
+        CHECK(ran_on_ui == 2);
+        CHECK(!run_on_ui_thread([] {}));
+        ui_thread_init(nullptr);
+    });
+
+    run_test("ui_thread_post", [&]() {
+        ui_thread_init(fake_post);
+        std::vector<int> order;
+        CHECK(post_to_ui_thread([&] { order.push_back(0); }));    // inline
+        std::thread worker([&] {
+            post_to_ui_thread([&] { order.push_back(1); });
+            run_on_ui_thread([&] { order.push_back(2); });
+        });
+        while (order.size() < 3) { fake_pump(); std::this_thread::yield(); }
+        worker.join();
+        CHECK((order == std::vector<int>{0, 1, 2}));
+
+        std::thread late([&] { post_to_ui_thread([&] { order.push_back(3); }); });
+        late.join();
+        ui_thread_shutdown();
+        fake_pump();                            // dropped after shutdown
+        CHECK(order.size() == 3);
+        CHECK(!post_to_ui_thread([] {}));
+        ui_thread_init(nullptr);
+    });
+
+    run_test("py_executor_commands", [&]() {
+        ExecWatch watch;
+        std::atomic<int> notified{0};
+        std::thread::id py_thread;
+        PyExecutor exec({
+            nullptr,
+            [&](PyObject* locals) {
+                py_thread = std::this_thread::get_id();
+                PyObject* v = PyLong_FromLong(41);
+                PyDict_SetItemString(locals, "seed", v);
+                Py_DECREF(v);
+                return true;
+            },
+            [&](bool more) { watch.on_done(more); },
+            [](void* n) { ++*static_cast<std::atomic<int>*>(n); },
+            &notified,
+        });
+        exec.start();
+        exec.submit("print(seed + 1)");
+        exec.submit("def f():");
+        CHECK(watch.wait_for(2));
+        CHECK(watch.more);
+        exec.submit("    return 'ok'");
+        exec.submit("");
+        exec.submit("print(f())");
+        exec.submit("1/0");
+        CHECK(watch.wait_for(6));
+        CHECK(!watch.more);
+        CHECK(py_thread != std::this_thread::get_id());
+        CHECK(notified > 0);
+        std::string out = exec.take_output();
+        CHECK(out.compare(0, 7, "Python ") == 0);
+        CHECK_CONTAINS(out, "42\nok\n");
+        CHECK_CONTAINS(out, "ZeroDivisionError");
+        exec.submit("raise SystemExit(3)");
+        CHECK(watch.wait_for(7));
+        CHECK_CONTAINS(exec.take_output(), "exit() is disabled");
+        exec.shutdown();
+    });
+
+    run_test("py_executor_interrupt", [&]() {
+        ExecWatch watch;
+        PyExecutor exec({nullptr, nullptr, [&](bool more) { watch.on_done(more); }, nullptr, nullptr});
+        exec.start();
+        exec.submit("while True: pass");
+        CHECK(watch.wait_for(1));               // compound statement: more input
+        exec.submit("");                        // ...runs the loop
+        exec.submit("print('dropped')");
+        auto t0 = std::chrono::steady_clock::now();
+        while (!exec.busy() && std::chrono::steady_clock::now() - t0 < std::chrono::seconds(10))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        CHECK(exec.busy());
+        exec.interrupt();
+        CHECK(watch.wait_for(2));
+        exec.submit("print('after')");
+        CHECK(watch.wait_for(3));
+        std::string out = exec.take_output();
+        CHECK_CONTAINS(out, "KeyboardInterrupt");
+        CHECK_CONTAINS(out, "after\n");
+        CHECK(out.find("dropped") == std::string::npos);
+
+        // shutdown() interrupts a running command before finalizing.
+        exec.submit("while True: pass");
+        CHECK(watch.wait_for(4));
+        exec.submit("");
+        while (!exec.busy()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        exec.shutdown();
+        CHECK(!exec.busy());
+    });
+
+    // Ctrl+C during graph_sweep/graph_render, which run with the GIL
+    // released: the calls poll the executor's flag and raise a single
+    // KeyboardInterrupt instead of running to completion.
+    run_test("py_executor_interrupts_graph_calls", [&]() {
+        ExecWatch watch;
+        PyExecutor exec({[] { fltkgraph_register(kFakeGraph); }, nullptr,
+                         [&](bool more) { watch.on_done(more); }, nullptr, nullptr});
+        exec.start();
+        auto interrupt_after = [&](int done, const char* line) {
+            exec.submit(line);
+            while (!exec.busy() && watch.done < done)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            auto t0 = std::chrono::steady_clock::now();
+            exec.interrupt();
+            CHECK(watch.wait_for(done));
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        };
+        auto count = [](const std::string& s, const char* word) {
+            int n = 0;
+            for (auto at = s.find(word); at != std::string::npos; at = s.find(word, at + 1)) ++n;
+            return n;
+        };
+
+        CHECK(interrupt_after(1, "r = __import__('fltkgraph').graph_sweep("
+                                 "delta=(0, 1, 100000), points=1000000, threads=2)") < 5.0);
+        std::string out = exec.take_output();
+        CHECK(count(out, "KeyboardInterrupt") == 1);
+
+        // Whether Ctrl+C lands inside a render or between two, it ends the
+        // loop with one exception.
+        g_fg_params.num_points = GraphParams::kMaxPoints;
+        CHECK(interrupt_after(2, "[__import__('fltkgraph').graph_render("
+                                 "'/tmp/fltk_test_interrupted.ppm', 4096, 4096) for _ in range(100)]") < 5.0);
+        out = exec.take_output();
+        CHECK(count(out, "KeyboardInterrupt") == 1);
+        g_fg_params = GraphParams{};
+
+        exec.submit("print('r' in dir())");
+        CHECK(watch.wait_for(3));
+        CHECK_STR(exec.take_output(), "False\n");
+        exec.shutdown();
+    });
+
+    run_test("tcl_executor_streams_puts", [&]() {
+        ExecWatch watch;
+        std::thread::id tcl_thread;
+        TclExecutor exec({
+            [&](Tcl_Interp*) { tcl_thread = std::this_thread::get_id(); },
+            [&] { watch.on_done(false); },
+            nullptr, nullptr,
+        });
+        exec.start();
+        exec.submit("puts -nonewline first; puts stdout {}; after 300; puts second");
+        std::string out;
+        auto t0 = std::chrono::steady_clock::now();
+        while (out.find("first\n") == std::string::npos &&
+               std::chrono::steady_clock::now() - t0 < std::chrono::seconds(10)) {
+            out += exec.take_output();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK_STR(out, "first\n");            // arrived while the script still runs
+        CHECK(exec.busy());
+        CHECK(watch.wait_for(1));
+        CHECK_STR(exec.take_output(), "second\n");
+        exec.submit("expr {6 * 7}");
+        exec.submit("error boom");
+        exec.submit("puts a b c d");
+        CHECK(watch.wait_for(4));
+        CHECK_STR(exec.take_output(),
+                  "42\nERROR: boom\nERROR: wrong # args: should be \"puts ?-nonewline? ?channelId? string\"\n");
+        CHECK(tcl_thread != std::this_thread::get_id());
+    });
+
+    run_test("tcl_executor_cancel", [&]() {
+        ExecWatch watch;
+        TclExecutor exec({nullptr, [&] { watch.on_done(false); }, nullptr, nullptr});
+        exec.start();
+        exec.submit("catch {while 1 {}} msg; puts caught");
+        exec.submit("puts dropped");
+        while (!exec.busy()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        exec.cancel();
+        CHECK(watch.wait_for(1));
+        exec.submit("set x 5");
+        CHECK(watch.wait_for(2));
+        CHECK_STR(exec.take_output(), "ERROR: eval unwound\n5\n");
+
+        exec.cancel();                          // idle: nothing to cancel
+        exec.submit("incr x");
+        exec.submit("incr x");
+        CHECK(watch.wait_for(4));
+        CHECK_STR(exec.take_output(), "6\n7\n");
+        ScriptCacheStats cs = exec.cache_stats();
+        CHECK(cs.hits == 1 && cs.misses == 3);
+
+        exec.submit("while 1 {}");
+        while (!exec.busy()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        exec.shutdown();                        // cancels the loop, then joins
+        CHECK(!exec.busy());
+    });
 }
 
 // ═════════════════════════════════════════════════════════════════
@@ -390,6 +1082,8 @@ static void run_graph_tests() {
         CHECK_NEAR(p.get("delta"), 1.23, 1e-9);
         CHECK(p.set("points", 500));
         CHECK_NEAR(p.get("points"), 500.0, 1e-9);
+        CHECK(p.set("points", 1e12));
+        CHECK(p.num_points == GraphParams::kMaxPoints);
     });
 
     run_test("graph_set_unknown", []() {
@@ -434,14 +1128,75 @@ static void run_graph_tests() {
         GraphParams p;
         p.set("a", 4.0);
         p.set("b", 5.0);
-        auto m = p.all();
-        CHECK(m.size() == 6);
-        CHECK_NEAR(m["a"], 4.0, 1e-9);
-        CHECK_NEAR(m["b"], 5.0, 1e-9);
-        CHECK(m.count("A") == 1);
-        CHECK(m.count("B") == 1);
-        CHECK(m.count("delta") == 1);
-        CHECK(m.count("points") == 1);
+        auto vals = p.values();
+        CHECK(vals.size() == kParamCount);
+        for (std::size_t i = 0; i < vals.size(); ++i) {
+            CHECK(vals[i].id == kParamDescs[i].id);
+            CHECK(std::strcmp(vals[i].name, kParamDescs[i].name) == 0);
+        }
+        CHECK_NEAR(vals[int(ParamId::a)].value, 4.0, 1e-9);
+        CHECK_NEAR(vals[int(ParamId::b)].value, 5.0, 1e-9);
+        CHECK_NEAR(vals[int(ParamId::points)].value, 1000.0, 1e-9);
+
+        // Defaults sit inside their slider ranges, which set() accepts.
+        GraphParams d;
+        for (const ParamDesc& desc : kParamDescs) {
+            CHECK(d.get(desc.id) >= desc.lo && d.get(desc.id) <= desc.hi);
+            CHECK(desc.step > 0.0);
+            CHECK(desc.min <= desc.lo && desc.hi <= desc.max);
+        }
+        // The points slider is logarithmic and reaches set()'s maximum.
+        const ParamDesc& pts = param_desc(ParamId::points);
+        CHECK(pts.log && !param_desc(ParamId::a).log);
+        CHECK_NEAR(slider_pos(pts, 1e7), 7.0, 1e-12);
+        CHECK(slider_value(pts, slider_pos(pts, pts.hi)) == GraphParams::kMaxPoints);
+        for (double n : {100.0, 1000.0, 5000.0, 250000.0})
+            CHECK(slider_value(pts, slider_pos(pts, n)) == n);
+        CHECK(slider_value(pts, 2.0 + pts.step) == 102.0);
+        CHECK(slider_pos(pts, 1.0) == slider_pos(pts, pts.lo));   // console value under lo
+        CHECK(slider_value(param_desc(ParamId::a), 4.0) == 4.0);
+        d.set(ParamId::points, 0.0);
+        CHECK(d.num_points == 1);
+        d.set(ParamId::points, 2e9);
+        CHECK(d.num_points == GraphParams::kMaxPoints);
+    });
+
+    run_test("graph_param_ids", []() {
+        GraphParams p;
+        int n = 0;
+        for (; GraphParams::kParamNames[n]; ++n) {
+            ParamId id;
+            CHECK(GraphParams::param_id(GraphParams::kParamNames[n], id));
+            CHECK(static_cast<int>(id) == n);
+            p.set(id, 7.0 + n);
+            CHECK_NEAR(p.get(GraphParams::kParamNames[n]), 7.0 + n, 1e-9);
+        }
+        CHECK(n == 6);
+        ParamId id;
+        CHECK(!GraphParams::param_id("nope", id));
+        CHECK(!GraphParams::param_id("", id));
+        CHECK(!GraphParams::param_id("alpha", id));   // same slot as "a"
+        CHECK(!GraphParams::param_id("c", id));
+        p.set(ParamId::points, 1e12);
+        CHECK(p.num_points == GraphParams::kMaxPoints);
+
+        // The table drives Tcl_GetIndexFromObj, which caches the match.
+        Tcl_Interp* interp = Tcl_CreateInterp();
+        Tcl_Obj* word = Tcl_NewStringObj("delta", -1);
+        Tcl_IncrRefCount(word);
+        int index = -1;
+        CHECK(Tcl_GetIndexFromObj(interp, word, GraphParams::kParamNames.data(), "parameter",
+                                  TCL_EXACT, &index) == TCL_OK);
+        CHECK(index == static_cast<int>(ParamId::delta));
+        CHECK(word->typePtr && std::strcmp(word->typePtr->name, "index") == 0);
+        Tcl_Obj* bad = Tcl_NewStringObj("d", -1);
+        Tcl_IncrRefCount(bad);
+        CHECK(Tcl_GetIndexFromObj(interp, bad, GraphParams::kParamNames.data(), "parameter",
+                                  TCL_EXACT, &index) == TCL_ERROR);
+        CHECK_CONTAINS(Tcl_GetStringResult(interp), "bad parameter \"d\": must be a, b, delta, A, B, or points");
+        Tcl_DecrRefCount(bad);
+        Tcl_DecrRefCount(word);
+        Tcl_DeleteInterp(interp);
     });
 
     run_test("graph_eval_lissajous", []() {
@@ -468,13 +1223,787 @@ static void run_graph_tests() {
         CHECK_NEAR(x1, 0.0, 1e-6);
         CHECK_NEAR(y1, 3.0, 1e-6);   // B * sin(pi/2)
     });
+
+    run_test("sin_batch_matches_libm", []() {
+        std::vector<double> in(4099), out(in.size());
+        for (std::size_t i = 0; i < in.size(); ++i)
+            in[i] = -200.0 + 400.0 * i / (in.size() - 1);
+        sin_batch(in.data(), out.data(), in.size());
+        for (std::size_t i = 0; i < in.size(); ++i)
+            CHECK_NEAR(out[i], std::sin(in[i]), 1e-13);
+        // Odd tail lengths and in-place use.
+        sin_batch(in.data(), in.data(), 3);
+        CHECK_NEAR(in[2], std::sin(-200.0 + 800.0 / 4098), 1e-13);
+        CHECK(std::strlen(sin_batch_isa()) > 0);
+    });
+
+    run_test("sin_batch_large_and_nonfinite", []() {
+        const double inf = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        // Out-of-range lanes mixed with ordinary ones, across vector
+        // blocks and the scalar tail.
+        std::vector<double> in = {1.0, 1e17, -2.5, 1e300, inf, 0.5, -1e20, nan, 3.0,
+                                  -inf, 1.5e8, 1e8};
+        std::vector<double> out(in.size());
+        sin_batch(in.data(), out.data(), in.size());
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            double want = std::sin(in[i]);
+            if (std::isnan(want)) CHECK(std::isnan(out[i]));
+            else                  CHECK_NEAR(out[i], want, 1e-13);
+        }
+        std::vector<double> inplace = in;
+        sin_batch(inplace.data(), inplace.data(), inplace.size());
+        CHECK_NEAR(inplace[1], std::sin(1e17), 1e-13);
+        CHECK_NEAR(inplace[3], std::sin(1e300), 1e-13);
+        CHECK(std::isnan(inplace[4]) && std::isnan(inplace[7]));
+    });
+
+    run_test("graph_eval_range_matches_eval", []() {
+        GraphParams p;
+        p.load_preset("star");
+        p.A = 1.7;
+        const std::size_t n = 5001;
+        std::vector<double> xs(n), ys(n);
+        p.eval_range(0.0, 2.0 * M_PI, n, xs.data(), ys.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            auto [ex, ey] = p.eval(2.0 * M_PI * i / (n - 1));
+            CHECK_NEAR(xs[i], ex, 1e-12);
+            CHECK_NEAR(ys[i], ey, 1e-12);
+        }
+    });
+
+    run_test("graph_eval_many", []() {
+        GraphParams p;
+        std::vector<double> ts = {0.0, 0.5, M_PI, -3.0, 12.5};
+        std::vector<double> xs(ts.size()), ys(ts.size());
+        p.eval_many(ts.data(), ts.size(), xs.data(), ys.data());
+        for (std::size_t i = 0; i < ts.size(); ++i) {
+            auto [ex, ey] = p.eval(ts[i]);
+            CHECK_NEAR(xs[i], ex, 1e-12);
+            CHECK_NEAR(ys[i], ey, 1e-12);
+        }
+    });
+
+    run_test("graph_fingerprint", []() {
+        GraphParams p, q;
+        CHECK(p.fingerprint() == q.fingerprint());
+        q.set("delta", 0.5);
+        CHECK(p.fingerprint() != q.fingerprint());
+        q.set("delta", p.delta);
+        CHECK(p.fingerprint() == q.fingerprint());
+        q.set("points", 2000);
+        CHECK(p.fingerprint() != q.fingerprint());
+    });
+
+    run_test("curve_buffer_rebuilds_on_change_only", []() {
+        GraphParams p;
+        CurveBuffer cb;
+        CHECK(cb.update(p));
+        CHECK(cb.size() == static_cast<std::size_t>(p.num_points) + 1);
+        CHECK(!cb.update(p));       // unchanged: cached
+        CHECK(!cb.update(p));
+        p.a = 4.0;                  // direct field writes are seen too
+        CHECK(cb.update(p));
+        auto [x0, y0] = p.eval(0.0);
+        CHECK_NEAR(cb.xs[0], x0, 1e-12);
+        CHECK_NEAR(cb.ys[0], y0, 1e-12);
+        cb.invalidate();
+        CHECK(cb.update(p));
+    });
+
+    run_test("sample_plan_coprime_full_range", []() {
+        GraphParams p;
+        p.load_preset("star");      // a=5, b=6: closes only after 2π
+        auto plan = p.sample_plan();
+        CHECK(plan.periods == 1);
+        CHECK_NEAR(plan.t1, 2.0 * M_PI, 1e-12);
+        CHECK(plan.count == static_cast<std::size_t>(p.num_points) + 1);
+    });
+
+    run_test("sample_plan_common_factor", []() {
+        GraphParams p;
+        p.a = 4; p.b = 6;           // gcd 2: period π
+        auto plan = p.sample_plan();
+        CHECK(plan.periods == 2);
+        CHECK_NEAR(plan.t1, M_PI, 1e-12);
+        CHECK(plan.count == static_cast<std::size_t>(p.num_points) + 1);
+        auto [x0, y0] = p.eval(plan.t0);
+        auto [x1, y1] = p.eval(plan.t1);
+        CHECK_NEAR(x0, x1, 1e-9);   // the sampled window is a closed loop
+        CHECK_NEAR(y0, y1, 1e-9);
+        auto lean = p.sample_plan(false);
+        CHECK(lean.count == static_cast<std::size_t>(p.num_points) / 2 + 1);
+
+        p.a = 1.5; p.b = 4.5;       // gcd 3/2: period 4π/3
+        CHECK(p.sample_plan().periods == 1);
+        p.a = 3.0; p.b = 4.5;       // gcd 3/2 -> 3/2 periods, not an integer
+        CHECK(p.sample_plan().periods == 1);
+        p.a = 2.5; p.b = 5.0;       // gcd 5/2 -> not an integer either
+        CHECK(p.sample_plan().periods == 1);
+        p.a = 6.0; p.b = 9.0;       // gcd 3
+        CHECK(p.sample_plan().periods == 3);
+    });
+
+    run_test("sample_plan_irrational_fallback", []() {
+        GraphParams p;
+        p.a = std::sqrt(2.0) * 2.0; p.b = std::sqrt(2.0) * 4.0;
+        auto plan = p.sample_plan();
+        CHECK(plan.periods == 1);
+        CHECK_NEAR(plan.t0, 0.0, 1e-12);
+        CHECK_NEAR(plan.t1, 2.0 * M_PI, 1e-12);
+    });
+
+    run_test("graph_set_sampling", []() {
+        GraphParams p;
+        CHECK_STR(p.sampling_name(), "uniform");
+        auto before = p.fingerprint();
+        CHECK(p.set_sampling("adaptive"));
+        CHECK(p.sampling == Sampling::adaptive);
+        CHECK(p.fingerprint() != before);
+        CHECK(!p.set_sampling("bogus"));
+        CHECK_STR(p.sampling_name(), "adaptive");
+    });
+
+    run_test("adaptive_sampling_error_bound", []() {
+        GraphParams p;
+        p.load_preset("star");      // a=5, b=6
+        p.num_points = 5000;
+        const double px_per_unit = 330.0 / 1.15;   // 680px canvas
+        std::vector<double> xs, ys, ts;
+        sample_adaptive(p, p.sample_plan(), px_per_unit, 0.25, xs, ys, &ts);
+        CHECK(xs.size() == ts.size());
+        CHECK(xs.size() < static_cast<std::size_t>(p.num_points) / 2);
+        CHECK_NEAR(ts.front(), 0.0, 1e-12);
+        CHECK_NEAR(ts.back(), 2.0 * M_PI, 1e-12);
+
+        // Every point of a dense uniform sampling lies within tol_px of the
+        // adaptive polyline segment covering its t.
+        for (int i = 0; i <= 100000; ++i) {
+            double t = 2.0 * M_PI * i / 100000;
+            auto it = std::upper_bound(ts.begin(), ts.end(), t);
+            std::size_t j = std::min<std::size_t>(it - ts.begin(), ts.size() - 1);
+            if (j == 0) j = 1;
+            auto [x, y] = p.eval(t);
+            double dx = xs[j] - xs[j - 1], dy = ys[j] - ys[j - 1];
+            double len2 = dx * dx + dy * dy;
+            double u = len2 > 0 ? ((x - xs[j - 1]) * dx + (y - ys[j - 1]) * dy) / len2 : 0;
+            u = std::min(1.0, std::max(0.0, u));
+            double ex = xs[j - 1] + u * dx - x, ey = ys[j - 1] + u * dy - y;
+            CHECK(std::sqrt(ex * ex + ey * ey) * px_per_unit < 0.25);
+        }
+
+        // Frequencies far past int range stay bounded by the vertex budget.
+        for (double a : {1e12, std::numeric_limits<double>::infinity()}) {
+            p.a = a;
+            sample_adaptive(p, p.sample_plan(), px_per_unit, 0.25, xs, ys);
+            CHECK(!xs.empty());
+            CHECK(xs.size() <= static_cast<std::size_t>(kAdaptiveMaxVertices));
+        }
+    });
+
+    run_test("curve_buffer_adaptive_keyed_on_scale", []() {
+        GraphParams p;
+        p.set_sampling("adaptive");
+        CurveBuffer cb;
+        CHECK(cb.update(p, 200.0));
+        CHECK(!cb.update(p, 200.0));
+        std::size_t small = cb.size();
+        CHECK(cb.update(p, 800.0));     // resize changes the error budget
+        CHECK(cb.size() > small);
+    });
+
+    run_test("sin_sequence_matches_libm", []() {
+        const double phase0 = 0.3, step = 0.0137;
+        for (std::size_t n : {1u, 63u, 64u, 257u, 1000u, 4099u}) {
+            std::vector<double> out(n);
+            sin_sequence(phase0, step, n, out.data());
+            for (std::size_t i = 0; i < n; ++i)
+                CHECK_NEAR(out[i], std::sin(phase0 + step * i), 1e-13);
+        }
+    });
+
+    run_test("graph_recurrence_engine_error_bound", []() {
+        const char* presets[] = {"circle", "figure8", "lissajous", "star", "bowtie"};
+        for (const char* name : presets) {
+            GraphParams p;
+            p.load_preset(name);
+            p.A = 1.9; p.B = 0.7;
+            CHECK(p.set_engine("recurrence"));
+            for (std::size_t n : {std::size_t(5001), std::size_t(1000001)}) {
+                std::vector<double> xs(n), ys(n);
+                p.eval_range(0.0, 2.0 * M_PI, n, xs.data(), ys.data());
+                double worst = 0.0;
+                for (std::size_t i = 0; i < n; i += (n > 10000 ? 7 : 1)) {
+                    auto [ex, ey] = p.eval(2.0 * M_PI * i / (n - 1));
+                    worst = std::max({worst, std::fabs(xs[i] - ex), std::fabs(ys[i] - ey)});
+                }
+                CHECK(worst < 1e-12);
+            }
+        }
+    });
+
+    run_test("graph_set_engine", []() {
+        GraphParams p;
+        CHECK_STR(p.engine_name(), "simd");
+        auto before = p.fingerprint();
+        CHECK(p.set_engine("recurrence"));
+        CHECK(p.engine == EvalEngine::recurrence);
+        CHECK(p.fingerprint() != before);
+        CHECK(!p.set_engine("bogus"));
+        CHECK(p.set_engine("simd"));
+        CHECK(p.fingerprint() == before);
+    });
+
+    run_test("curve_buffer_rebuild_chunks", []() {
+        GraphParams p;
+        p.num_points = 100000;
+        CurveBuffer cb;
+        cb.rebuild(p, 0.0);
+        CHECK(cb.valid);
+        CHECK(cb.key == CurveBuffer::key_for(p, 0.0));
+        auto [xl, yl] = p.eval(2.0 * M_PI);
+        CHECK_NEAR(cb.xs.back(), xl, 1e-12);   // chunk seams land on the grid
+        CHECK_NEAR(cb.ys.back(), yl, 1e-12);
+    });
+
+    run_test("curve_worker_streams_in_background", []() {
+        std::mutex mu;
+        std::condition_variable cv;
+        unsigned long ready = 0;
+        CurveWorker worker([&] {
+            std::lock_guard<std::mutex> lk(mu);
+            ++ready;
+            cv.notify_all();
+        });
+
+        GraphParams p;
+        p.num_points = 200000;
+        worker.request(p, 680, 680);
+        p.a = 4.0;
+        p.num_points = 2000000;
+        worker.request(p, 680, 680);    // supersedes the first
+        worker.request(p, 680, 680);    // duplicate: ignored
+
+        std::uint64_t want = CurveWorker::key_for(p, 680, 680);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+        bool got = false;
+        while (!got && std::chrono::steady_clock::now() < deadline) {
+            {
+                std::unique_lock<std::mutex> lk(mu);
+                cv.wait_for(lk, std::chrono::milliseconds(50));
+            }
+            worker.with_front([&](const ScreenCurve& sc) {
+                got = sc.valid && sc.complete && sc.key == want;
+            });
+        }
+        CHECK(got);
+        worker.with_front([&](const ScreenCurve& sc) {
+            CHECK(sc.samples == 2000001);
+            CHECK(sc.line.pushed() == 2000001);
+            CHECK(sc.line.size() < 2000);       // bounded by the screen shape
+            CurveProjection proj = CurveProjection::fit(p, 680, 680);
+            auto [x0, y0] = p.eval(0.0);
+            CHECK_NEAR(sc.line.xs().front(), proj.sx(x0), 1e-9);
+            CHECK_NEAR(sc.line.ys().front(), proj.sy(y0), 1e-9);
+        });
+        CHECK(worker.completed() >= 1);
+        CHECK(worker.completed() + worker.cancelled() <= 2);
+        CHECK(CurveWorker::key_for(p, 680, 680) != CurveWorker::key_for(p, 680, 400));
+    });
+
+    run_test("curve_worker_stop_silences_ready", []() {
+        std::atomic<unsigned long> ready{0};
+        CurveWorker worker([&] { ++ready; });
+
+        GraphParams p;
+        p.num_points = 2000000;
+        worker.request(p, 680, 680);
+        worker.stop();                  // cancels the build in flight
+        unsigned long seen = ready;
+        CHECK(worker.completed() + worker.cancelled() <= 1);
+
+        p.a = 4.0;
+        worker.request(p, 680, 680);    // ignored after stop
+        worker.stop();                  // idempotent
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        CHECK(ready == seen);
+        worker.with_front([&](const ScreenCurve& sc) {
+            CHECK(!sc.valid || sc.key != CurveWorker::key_for(p, 680, 680));
+        });
+    });
+
+    run_test("stream_curve_matches_buffered", []() {
+        GraphParams p;
+        p.load_preset("lissajous");
+        p.num_points = 100000;
+        CurveProjection proj = CurveProjection::fit(p, 500, 400);
+        SamplePlan plan = p.sample_plan();
+
+        PolylineDecimator streamed;
+        CHECK(stream_curve(p, plan, proj, streamed));
+        CHECK(streamed.pushed() == plan.count);
+
+        std::vector<double> xs(plan.count), ys(plan.count);
+        p.eval_range(plan.t0, plan.t1, plan.count, xs.data(), ys.data());
+        PolylineDecimator whole;
+        for (std::size_t i = 0; i < plan.count; ++i)
+            whole.push(proj.sx(xs[i]), proj.sy(ys[i]));
+        whole.finish();
+        CHECK(streamed.size() == whole.size());
+        for (std::size_t i = 0; i < whole.size(); ++i) {
+            CHECK_NEAR(streamed.xs()[i], whole.xs()[i], 1e-9);
+            CHECK_NEAR(streamed.ys()[i], whole.ys()[i], 1e-9);
+        }
+
+        int polls = 0;
+        CHECK(!stream_curve(p, plan, proj, streamed, [&polls] { return ++polls > 1; }));
+    });
+
+    run_test("render_graph_headless", []() {
+        GraphParams p;
+        RgbaImage img = render_graph(p, 200, 150);
+        CHECK(img.w == 200 && img.h == 150);
+        CHECK(img.px.size() == 200u * 150u * 4u);
+        const std::uint8_t* bg = img.at(1, 1);
+        CHECK(bg[0] == 12 && bg[1] == 12 && bg[2] == 22 && bg[3] == 255);
+        const std::uint8_t* axis = img.at(100, 5);     // y axis, above the curve
+        CHECK(axis[0] == 70 && axis[1] == 70 && axis[2] == 90);
+
+        CurveProjection proj = CurveProjection::fit(p, 200, 150);
+        auto [x0, y0] = p.eval(0.0);
+        const std::uint8_t* on = img.at(static_cast<int>(std::lround(proj.sx(x0))),
+                                        static_cast<int>(std::lround(proj.sy(y0))));
+        CHECK(on[1] > 200 && on[0] < 40);               // fully covered by the curve
+        int partial = 0;                                // anti-aliased edge pixels
+        for (std::size_t i = 0; i < img.px.size(); i += 4)
+            if (img.px[i + 1] > 30 && img.px[i + 1] < 200) ++partial;
+        CHECK(partial > 50);
+
+        CHECK(render_graph(p, 0, 10).px.empty());
+        CHECK(render_graph(p, 10, kMaxRenderSize + 1).px.empty());
+        CHECK(kMaxRenderSize == 4096);
+        CHECK(render_graph(p, 20, 20, [] { return true; }).px.empty());
+        p.sampling = Sampling::adaptive;
+        CHECK(render_graph(p, 20, 20, [] { return true; }).px.empty());
+    });
+
+    run_test("render_graph_writes_ppm_and_png", []() {
+        GraphParams p;
+        p.load_preset("star");
+        RgbaImage img = render_graph(p, 64, 48);
+        auto slurp = [](const char* path) {
+            std::vector<std::uint8_t> buf;
+            FILE* f = std::fopen(path, "rb");
+            if (!f) return buf;
+            int c;
+            while ((c = std::fgetc(f)) != EOF) buf.push_back(static_cast<std::uint8_t>(c));
+            std::fclose(f);
+            return buf;
+        };
+
+        const char* ppm = "/tmp/fltk_test_render.ppm";
+        CHECK(write_image(img, ppm));
+        auto data = slurp(ppm);
+        const char hdr[] = "P6\n64 48\n255\n";
+        CHECK(data.size() == sizeof(hdr) - 1 + 64 * 48 * 3);
+        CHECK(std::memcmp(data.data(), hdr, sizeof(hdr) - 1) == 0);
+        CHECK(data[sizeof(hdr) - 1 + 3 * (10 * 64 + 20) + 1] == img.at(20, 10)[1]);
+        std::remove(ppm);
+
+        const char* png = "/tmp/fltk_test_render.PNG";
+        CHECK(write_image(img, png));
+        data = slurp(png);
+        std::remove(png);
+        CHECK(data.size() > 8 + 25 + 12);
+        CHECK(std::memcmp(data.data(), "\x89PNG\r\n\x1a\n", 8) == 0);
+        auto be32 = [&](std::size_t at) {
+            return (std::uint32_t(data[at]) << 24) | (std::uint32_t(data[at + 1]) << 16)
+                 | (std::uint32_t(data[at + 2]) << 8) | data[at + 3];
+        };
+        CHECK(std::memcmp(&data[12], "IHDR", 4) == 0);
+        CHECK(be32(16) == 64 && be32(20) == 48);
+        CHECK(data[24] == 8 && data[25] == 6);
+
+        // Decode the stored-deflate IDAT and compare with the framebuffer.
+        std::size_t idat = 8 + 25;
+        CHECK(std::memcmp(&data[idat + 4], "IDAT", 4) == 0);
+        std::size_t pos = idat + 8 + 2, end = idat + 8 + be32(idat);
+        std::vector<std::uint8_t> raw;
+        for (bool last = false; !last && pos + 5 <= end; ) {
+            last = data[pos] & 1;
+            std::size_t len = data[pos + 1] | (data[pos + 2] << 8);
+            CHECK(((data[pos + 3] | (data[pos + 4] << 8)) ^ len) == 0xffff);
+            raw.insert(raw.end(), data.begin() + pos + 5, data.begin() + pos + 5 + len);
+            pos += 5 + len;
+        }
+        CHECK(raw.size() == 48u * (1 + 64 * 4));
+        bool same = raw.size() == 48u * (1 + 64 * 4);
+        for (int y = 0; same && y < 48; ++y) {
+            same = raw[y * (1 + 64 * 4)] == 0 &&
+                   std::memcmp(&raw[y * (1 + 64 * 4) + 1], img.at(0, y), 64 * 4) == 0;
+        }
+        CHECK(same);
+        CHECK(!write_image(RgbaImage(), "/tmp/fltk_test_empty.ppm"));
+    });
+
+    run_test("parallel_for_steals_uneven_work", []() {
+        const std::size_t n = 2000;
+        std::vector<std::atomic<int>> hits(n);
+        std::vector<std::atomic<int>> per_worker(4);
+        parallel_for(n, 4, [&](std::size_t i, unsigned w) {
+            if (i < 10) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            ++hits[i];
+            ++per_worker[w];
+        });
+        bool once = true;
+        for (auto& h : hits) once = once && h == 1;
+        CHECK(once);
+        // Worker 0 holds the slow items; the others must have stolen from it.
+        CHECK(per_worker[0] < static_cast<int>(n / 4));
+        int calls = 0;
+        parallel_for(0, 4, [&](std::size_t, unsigned) { ++calls; });
+        CHECK(calls == 0);
+    });
+
+    run_test("parallel_for_cancel", []() {
+        // Polled only on the calling thread; every worker stops soon after.
+        const auto caller = std::this_thread::get_id();
+        std::atomic<int> done{0};
+        int polls = 0;
+        bool other_thread = false;
+        bool finished = parallel_for(100000, 4, [&](std::size_t, unsigned) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            ++done;
+        }, [&] {
+            other_thread = other_thread || std::this_thread::get_id() != caller;
+            return ++polls > 20;
+        });
+        CHECK(!finished);
+        CHECK(!other_thread);
+        CHECK(done < 1000);
+
+        int serial = 0;
+        CHECK(!parallel_for(100, 1, [&](std::size_t, unsigned) { ++serial; },
+                            [&] { return serial == 5; }));
+        CHECK(serial == 5);
+        CHECK(parallel_for(100, 4, [](std::size_t, unsigned) {}, [] { return false; }));
+
+        // The caller runs dry at once but keeps polling, and a long item
+        // on another worker sees `halted` mid-item.
+        std::atomic<bool> saw_halt{false};
+        auto t0 = std::chrono::steady_clock::now();
+        polls = 0;
+        finished = parallel_for(2, 2, [&](std::size_t i, unsigned,
+                                          const std::function<bool()>& halted) {
+            if (i == 0) return;
+            while (!halted() && std::chrono::steady_clock::now() - t0 < std::chrono::seconds(10))
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            saw_halt = halted();
+        }, [&] {
+            other_thread = other_thread || std::this_thread::get_id() != caller;
+            return ++polls > 20;
+        });
+        CHECK(!finished);
+        CHECK(saw_halt);
+        CHECK(!other_thread);
+        CHECK(std::chrono::steady_clock::now() - t0 < std::chrono::seconds(5));
+    });
+
+    run_test("self_intersections_grid_matches_brute_force", []() {
+        auto count = [](const char* preset) {
+            GraphParams p;
+            p.load_preset(preset);
+            std::vector<double> xs, ys;
+            return self_intersections(p, xs, ys);
+        };
+        CHECK(count("circle") == 0);
+        CHECK(count("figure8") == 1);
+
+        // Generic Lissajous (a, b coprime, generic phase): 2ab - a - b crossings.
+        GraphParams p;
+        p.a = 3; p.b = 2; p.delta = 0.3;
+        std::vector<double> xs, ys;
+        CHECK(self_intersections(p, xs, ys) == 2 * 3 * 2 - 3 - 2);
+
+        p.load_preset("star");
+        p.delta = 0.3;
+        long grid = self_intersections(p, xs, ys);
+        long brute = 0;
+        std::size_t segs = xs.size() - 1;
+        for (std::size_t i = 0; i < segs; ++i) {
+            for (std::size_t j = i + 2; j < segs; ++j) {
+                if (i == 0 && j == segs - 1) continue;
+                auto side = [&](std::size_t k, std::size_t m) {
+                    return (xs[k + 1] - xs[k]) * (ys[m] - ys[k]) - (ys[k + 1] - ys[k]) * (xs[m] - xs[k]);
+                };
+                if (side(i, j) * side(i, j + 1) < 0 && side(j, i) * side(j, i + 1) < 0) ++brute;
+            }
+        }
+        CHECK(grid == brute);
+        CHECK(grid == 2 * 5 * 6 - 5 - 6);
+    });
+
+    run_test("sweep_reducers_in_order", []() {
+        GraphParams p;
+        SweepSpec spec = SweepSpec::around(p);
+        spec.A = {0.5, 1.5, 3};
+        spec.b = {1.0, 2.0, 2};
+        spec.reducer = SweepReducer::bbox;
+        CHECK(spec.combinations() == 6);
+        auto res = run_sweep(spec);
+        CHECK(res.size() == 6);
+        CHECK_NEAR(res[0].b, 1.0, 1e-12);       // A varies faster than b
+        CHECK_NEAR(res[1].A, 1.0, 1e-12);
+        CHECK_NEAR(res[5].b, 2.0, 1e-12);
+        for (const auto& r : res) {
+            CHECK_NEAR(r.xmax, r.A, 1e-3);
+            CHECK_NEAR(r.xmin, -r.A, 1e-3);
+        }
+
+        spec = SweepSpec::around(p);
+        spec.A = {1.0, 2.0, 2};
+        spec.reducer = SweepReducer::arclength;
+        res = run_sweep(spec);
+        CHECK(res.size() == 2);
+        CHECK(res[1].length > res[0].length);
+
+        // Same answers whatever the thread count.
+        spec = SweepSpec::around(p);
+        spec.a = {1.0, 6.0, 6};
+        spec.b = {1.0, 6.0, 6};
+        spec.reducer = SweepReducer::selfintersections;
+        spec.threads = 1;
+        auto serial = run_sweep(spec);
+        spec.threads = 4;
+        auto parallel = run_sweep(spec);
+        CHECK(serial.size() == 36 && parallel.size() == 36);
+        bool same = true;
+        for (std::size_t i = 0; i < serial.size(); ++i)
+            same = same && serial[i].crossings == parallel[i].crossings;
+        CHECK(same);
+
+        // Absurd counts are clamped inside run_sweep, not handed to the pool.
+        spec.threads = 100000;
+        auto clamped = run_sweep(spec);
+        CHECK(clamped.size() == 36 && clamped[35].crossings == serial[35].crossings);
+
+        // A cancelled sweep returns nothing.
+        spec.threads = 4;
+        CHECK(run_sweep(spec, [] { return true; }).empty());
+        CHECK(run_sweep(spec, [] { return false; }).size() == 36);
+
+        // One dense combination is polled between its sample chunks.
+        SweepSpec dense = SweepSpec::around(GraphParams{});
+        dense.base.num_points = GraphParams::kMaxPoints;
+        int polls = 0;
+        CHECK(run_sweep(dense, [&] { return ++polls > 3; }).empty());
+        CHECK(polls == 4);
+
+        spec.a.steps = 0;
+        CHECK(run_sweep(spec).empty());
+    });
+
+    run_test("frame_scheduler_coalesces_bursts", []() {
+        FrameScheduler fs(50.0);            // 20 ms frames
+        CHECK_NEAR(fs.request(1.000), 0.0, 1e-12);
+        for (int i = 0; i < 30; ++i)        // slider drag burst
+            CHECK(fs.request(1.000 + i * 0.0005) < 0.0);
+        CHECK(fs.flush(1.001, 11));
+        double d = fs.request(1.005);       // next frame waits out the interval
+        CHECK_NEAR(d, 0.016, 1e-9);
+        CHECK(!fs.flush(1.021, 11));        // same state: dropped
+        CHECK_NEAR(fs.request(2.0), 0.0, 1e-12);
+        CHECK(fs.flush(2.0, 12));
+        const FrameStats& st = fs.stats();
+        CHECK(st.requests == 33);
+        CHECK(st.merged   == 30);
+        CHECK(st.frames   == 2);
+        CHECK(st.dropped  == 1);
+
+        // The keyless flush never drops.
+        CHECK_NEAR(fs.request(3.0), 0.0, 1e-12);
+        fs.flush(3.0);
+        CHECK(!fs.pending());
+        CHECK_NEAR(fs.request(3.001), 0.019, 1e-9);
+        fs.flush(3.02);
+        CHECK(fs.stats().frames == 4 && fs.stats().dropped == 1);
+    });
+
+    run_test("polyline_decimator_error_bound", []() {
+        GraphParams p;
+        p.load_preset("star");
+        const double k = 330.0 / 1.15, tol = 0.25;
+        auto project = [&](std::size_t n, std::vector<double>& px, std::vector<double>& py) {
+            std::vector<double> xs(n), ys(n);
+            p.eval_range(0.0, 2.0 * M_PI, n, xs.data(), ys.data());
+            px.resize(n); py.resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                px[i] = 340.0 + xs[i] * k;
+                py[i] = 340.0 - ys[i] * k;
+            }
+        };
+
+        std::vector<double> px, py;
+        project(20001, px, py);
+        PolylineDecimator d(tol);
+        for (std::size_t i = 0; i < px.size(); ++i) d.push(px[i], py[i]);
+        d.finish();
+        CHECK(d.pushed() == px.size());
+        CHECK(d.size() < px.size() / 20);
+        CHECK_NEAR(d.xs().front(), px.front(), 1e-12);
+        CHECK_NEAR(d.xs().back(),  px.back(),  1e-12);
+
+        // Every input vertex lies within ~tol of the simplified polyline.
+        for (std::size_t i = 0; i < px.size(); i += 3) {
+            double best = 1e300;
+            for (std::size_t j = 1; j < d.size(); ++j) {
+                double ax = d.xs()[j - 1], ay = d.ys()[j - 1];
+                double dx = d.xs()[j] - ax, dy = d.ys()[j] - ay;
+                double len2 = dx * dx + dy * dy;
+                double u = len2 > 0 ? ((px[i] - ax) * dx + (py[i] - ay) * dy) / len2 : 0;
+                u = std::min(1.0, std::max(0.0, u));
+                best = std::min(best, std::hypot(ax + u * dx - px[i], ay + u * dy - py[i]));
+            }
+            CHECK(best <= tol * 1.5);
+        }
+
+        // Output size tracks the on-screen shape, not the sample count.
+        project(1000001, px, py);
+        PolylineDecimator dense(tol);
+        for (std::size_t i = 0; i < px.size(); ++i) dense.push(px[i], py[i]);
+        dense.finish();
+        CHECK(dense.size() <= d.size() + d.size() / 10);
+    });
+
+    run_test("polyline_decimator_doubling_back", []() {
+        PolylineDecimator d(0.25);
+        for (int i = 0; i <= 100; ++i) d.push(i, 0.0);      // out ...
+        for (int i = 99; i >= 0; --i) d.push(i, 0.0);       // ... and back
+        d.finish();
+        CHECK(d.size() == 3);
+        CHECK_NEAR(d.xs()[1], 100.0, 1e-12);
+        d.reset();
+        CHECK(d.size() == 0);
+        d.push(5.0, 5.0);
+        d.finish();
+        CHECK(d.size() == 1);
+    });
+}
+
+// ═════════════════════════════════════════════════════════════════
+//  Console output tests (pure C++, no FLTK)
+// ═════════════════════════════════════════════════════════════════
+static void run_console_tests() {
+    std::cout << "\n=== Console output tests ===\n";
+
+    run_test("scrollback_trims_in_chunks", []() {
+        Scrollback sb(80);                  // chunk = 10 lines
+        std::string buf;                    // stands in for Fl_Text_Buffer
+        int trims = 0;
+        auto add = [&](const std::string& text) {
+            buf += text;
+            if (std::size_t drop = sb.append(text.data(), text.size())) {
+                buf.erase(0, drop);
+                ++trims;
+            }
+        };
+        for (int i = 0; i < 1000; ++i) {
+            add("line ");                   // written in pieces, like puts
+            add(std::to_string(i) + "\n");
+        }
+        ScrollbackStats st = sb.stats();
+        CHECK(st.lines >= 80 && st.lines <= 90);
+        CHECK(st.bytes == buf.size());
+        CHECK(st.trimmed == 1000 - st.lines);
+        CHECK(trims == static_cast<int>(st.trimmed / 11));   // 11 lines per trim
+        CHECK(buf.compare(0, 5, "line ") == 0);
+        CHECK(buf.compare(buf.size() - 9, 9, "line 999\n") == 0);
+        CHECK(st.index_bytes == st.lines * sizeof(std::size_t));
+
+        add("partial");                     // unterminated line counts once
+        CHECK(sb.stats().lines == st.lines + 1);
+        std::size_t drop = sb.set_limit(2);
+        buf.erase(0, drop);
+        CHECK_STR(buf, "line 999\npartial");
+        CHECK(sb.stats().bytes == buf.size());
+
+        CHECK(sb.set_limit(0) == 0);        // unlimited: never trims
+        for (int i = 0; i < 500; ++i) add("x\n");
+        CHECK(sb.stats().lines == 501);     // the first "x\n" closes "partial"
+        sb.clear();
+        CHECK(sb.stats().lines == 0 && sb.stats().bytes == 0);
+    });
+
+    run_test("output_stage_commits_batches", []() {
+        OutputStage out(4);                 // chunk = 1 line: trims past 5 lines
+        std::string buf;                    // stands in for Fl_Text_Buffer
+        int edits = 0;
+        auto commit = [&] {
+            out.commit(buf.size(), [&](std::size_t remove, const char* text) {
+                ++edits;
+                buf.erase(0, remove);
+                buf += text;
+            });
+        };
+        CHECK(!out.pending());
+        CHECK(out.stage("a\n", 2));        // first text: schedule a commit
+        CHECK(!out.stage("b\n", 2));       // merged into the same batch
+        CHECK(!out.stage("", 0));
+        CHECK(out.pending());
+        commit();
+        CHECK(edits == 1 && !out.pending());
+        CHECK_STR(buf, "a\nb\n");
+        commit();                           // nothing staged: no edit
+        CHECK(edits == 1);
+
+        // A trim inside the old contents: remove from the front, append all.
+        CHECK(out.stage("c\nd\ne\nf\n", 8));
+        commit();
+        CHECK_STR(buf, "c\nd\ne\nf\n");
+        CHECK(out.stats().lines == 4 && out.stats().bytes == buf.size());
+
+        // A burst bigger than the limit (drop >= have): the old contents go
+        // and the staged lines that would be trimmed are never appended.
+        std::string burst;
+        for (int i = 0; i < 10; ++i) burst += std::to_string(i) + "\n";
+        out.stage(burst.data(), burst.size());
+        std::size_t have = buf.size();
+        std::size_t removed = 0;
+        std::string appended;
+        out.commit(have, [&](std::size_t remove, const char* text) {
+            removed  = remove;
+            appended = text;
+        });
+        CHECK(removed == have);
+        CHECK_STR(appended, "6\n7\n8\n9\n");
+        CHECK(out.stats().lines == 4 && out.stats().bytes == appended.size());
+        CHECK(out.stats().trimmed == 12);
+
+        // Exactly the old contents dropped (drop == have).
+        buf = appended;
+        out.stage("w\nx\ny\nz\n", 8);
+        commit();
+        CHECK_STR(buf, "w\nx\ny\nz\n");
+
+        // An unterminated tail stays one line across commits.
+        out.stage("p", 1);
+        commit();
+        out.stage("q\n", 2);
+        commit();
+        CHECK_STR(buf, "w\nx\ny\nz\npq\n");  // 5 lines: not yet a chunk over
+        CHECK(out.stats().lines == 5);
+        CHECK(out.set_limit(2) == 6);
+        CHECK(out.stats().lines == 2);
+    });
 }
 
 // ═════════════════════════════════════════════════════════════════
 int main() {
     run_tcl_tests();
+    run_executor_tests();
     run_python_tests();
     run_graph_tests();
+    run_console_tests();
 
     std::cout << "\n=== Results: " << g_pass << " passed, "
               << g_fail << " failed ===\n";